@@ -1,97 +1,129 @@
-#pragma once
-
-#ifndef CRDFPLUGIN_H
-#define CRDFPLUGIN_H
-
-#include "stdafx.h"
-#include "HiddenWindow.h"
-#include "RDFCommon.h"
-#include "CRDFScreen.h"
-
-class CRDFPlugin : public EuroScopePlugIn::CPlugIn, public std::enable_shared_from_this<CRDFPlugin>
-{
-private:
-	friend class CRDFScreen;
-
-	// screen controls and drawing params
-	std::vector<std::shared_ptr<CRDFScreen>> vecScreen; // index is screen ID (incremental int)
-	std::shared_mutex mtxDrawSettings;
-	std::shared_ptr<RDFCommon::draw_settings> currentDrawSettings;
-
-	// drawing records
-	std::shared_mutex mtxTransmission;
-	RDFCommon::callsign_position curTransmission;
-	RDFCommon::callsign_position preTransmission;
-
-	// TrackAudio WebSocket
-	std::string addressTrackAudio;
-	ix::WebSocket socketTrackAudio;
-	auto TrackAudioMessageHandler(const ix::WebSocketMessagePtr& msg) -> void;
-
-	// AFV standalone client controls
-	HWND hiddenWindowRDF = NULL;
-	HWND hiddenWindowAFV = NULL;
-	WNDCLASS windowClassRDF = {
-	   NULL,
-	   HiddenWindowRDF,
-	   NULL,
-	   NULL,
-	   GetModuleHandle(NULL),
-	   NULL,
-	   NULL,
-	   NULL,
-	   NULL,
-	   "RDFHiddenWindowClass"
-	};
-	WNDCLASS windowClassAFV = {
-	   NULL,
-	   HiddenWindowAFV,
-	   NULL,
-	   NULL,
-	   GetModuleHandle(NULL),
-	   NULL,
-	   NULL,
-	   NULL,
-	   NULL,
-	   "AfvBridgeHiddenWindowClass"
-	};
-
-	// settings related functions
-	auto LoadTrackAudioSettings(void) -> void;
-	auto LoadDrawingSettings(std::optional<std::shared_ptr<CRDFScreen>> screenPtr) -> void;
-
-	// functional things 
-	auto GetBridgeMode(void) -> bool;
-	auto GenerateDrawPosition(std::string callsign) -> RDFCommon::draw_position;
-	auto TrackAudioTransmissionHandler(const nlohmann::json& data, const bool& rxEnd) -> void;
-	auto TrackAudioStationStatesHandler(const nlohmann::json& data) -> void;
-	auto TrackAudioStationStateUpdateHandler(const nlohmann::json& data) -> void;
-	auto SelectGroundToAirChannel(const std::optional<std::string>& callsign, const std::optional<int>& frequency) -> EuroScopePlugIn::CGrountToAirChannel;
-	auto UpdateChannel(const std::optional<std::string>& callsign, const std::optional<RDFCommon::chnl_state>& channelState) -> void;
-	auto ToggleChannel(EuroScopePlugIn::CGrountToAirChannel Channel, const std::optional<bool>& rx, const std::optional<bool>& tx) -> void;
-
-	// messages
-	inline auto DisplayMessageDebug(const std::string& msg) -> void {
-#ifdef _DEBUG
-		DisplayUserMessage("RDF-DEBUG", "", msg.c_str(), true, true, true, false, false);
-#endif // _DEBUG
-	}
-	inline auto DisplayMessageSilent(const std::string& msg) -> void {
-		DisplayUserMessage("Message", "RDF Plugin", msg.c_str(), false, false, false, false, false);
-	}
-	inline auto DisplayMessageUnread(const std::string& msg) -> void {
-		DisplayUserMessage("Message", "RDF Plugin", msg.c_str(), true, true, true, false, false);
-	}
-
-public:
-	CRDFPlugin();
-	~CRDFPlugin();
-	auto GetDrawStations(void) -> RDFCommon::callsign_position;
-	auto HiddenWndProcessRDFMessage(const std::string& message) -> void;
-	auto HiddenWndProcessAFVMessage(const std::string& message) -> void;
-	virtual auto OnRadarScreenCreated(const char* sDisplayName, bool NeedRadarContent, bool GeoReferenced, bool CanBeSaved, bool CanBeCreated) -> EuroScopePlugIn::CRadarScreen*;
-	virtual auto OnCompileCommand(const char* sCommandLine) -> bool;
-	virtual auto OnGetTagItem(EuroScopePlugIn::CFlightPlan FlightPlan, EuroScopePlugIn::CRadarTarget RadarTarget, int ItemCode, int TagData, char sItemString[16], int* pColorCode, COLORREF* pRGB, double* pFontSize) -> void;
-};
-
-#endif // !CRDFPLUGIN_H
+#pragma once
+
+#ifndef CRDFPLUGIN_H
+#define CRDFPLUGIN_H
+
+#include "stdafx.h"
+#include "HiddenWindow.h"
+#include "RDFCommon.h"
+#include "RDFEngine.h"
+#include "RDFHost.h"
+#include "RDFLog.h"
+#include "RDFReplay.h"
+#include "RDFTrace.h"
+#include "CRDFScreen.h"
+
+class CRDFPlugin : public EuroScopePlugIn::CPlugIn, public RDFCommon::plugin_host, public std::enable_shared_from_this<CRDFPlugin>
+{
+private:
+	friend class CRDFScreen;
+
+	// screen controls
+	std::vector<std::shared_ptr<CRDFScreen>> vecScreen; // index is screen ID (incremental int)
+
+	// records, events and bridge logic
+	RDFCommon::plugin_engine engine;
+	size_t countEventDropped = 0; // last reported
+
+	// ground to air channels of last enumeration, position is the handle of engine
+	std::vector<EuroScopePlugIn::CGrountToAirChannel> channelHandles;
+	static auto ChannelState(EuroScopePlugIn::CGrountToAirChannel channel) -> RDFCommon::chnl_state;
+
+	// TrackAudio WebSocket
+	std::string addressTrackAudio;
+	ix::WebSocket socketTrackAudio;
+	auto TrackAudioMessageHandler(const ix::WebSocketMessagePtr& msg) -> void;
+
+	// record & replay of inbound messages
+	std::filesystem::path pathPlugin; // directory of DLL
+	RDFCommon::replay_recorder recorderMessage;
+	std::thread threadReplay;
+	std::atomic<bool> replayStop = false;
+	std::atomic<bool> replayFinished = false;
+	RDFCommon::replay_stats replayStats;
+	auto StartReplay(const std::filesystem::path& path, const double& speed) -> bool;
+	auto StopReplay(void) -> void;
+	auto ReportReplay(void) -> void;
+
+	// AFV standalone client controls
+	HWND hiddenWindowRDF = NULL;
+	HWND hiddenWindowAFV = NULL;
+	WNDCLASS windowClassRDF = {
+	   NULL,
+	   HiddenWindowRDF,
+	   NULL,
+	   NULL,
+	   GetModuleHandle(NULL),
+	   NULL,
+	   NULL,
+	   NULL,
+	   NULL,
+	   "RDFHiddenWindowClass"
+	};
+	WNDCLASS windowClassAFV = {
+	   NULL,
+	   HiddenWindowAFV,
+	   NULL,
+	   NULL,
+	   GetModuleHandle(NULL),
+	   NULL,
+	   NULL,
+	   NULL,
+	   NULL,
+	   "AfvBridgeHiddenWindowClass"
+	};
+
+	// settings related functions
+	auto LoadTrackAudioSettings(void) -> void;
+	auto LoadDrawingSettings(std::optional<std::shared_ptr<CRDFScreen>> screenPtr) -> std::shared_ptr<const RDFCommon::draw_settings>;
+	auto ReloadDrawingSettings(void) -> void;
+	auto SetDrawingSettings(const std::shared_ptr<const RDFCommon::draw_settings>& settings) -> void;
+
+	// messages
+	inline auto DisplayMessageDebug(const std::string& msg) -> void {
+#ifdef _DEBUG
+		DisplayUserMessage("RDF-DEBUG", "", msg.c_str(), true, true, true, false, false);
+#endif // _DEBUG
+	}
+	inline auto DisplayMessageSilent(const std::string& msg) -> void {
+		DisplayUserMessage("Message", "RDF Plugin", msg.c_str(), false, false, false, false, false);
+	}
+	inline auto DisplayMessageUnread(const std::string& msg) -> void {
+		DisplayUserMessage("Message", "RDF Plugin", msg.c_str(), true, true, true, false, false);
+	}
+
+public:
+	CRDFPlugin();
+	~CRDFPlugin();
+	auto GetDrawStations(void) -> std::shared_ptr<const RDFCommon::callsign_position>;
+	auto HiddenWndProcessRDFMessage(const std::string& message) -> void;
+	auto HiddenWndProcessAFVMessage(const std::string& message) -> void;
+	auto ProcessEvents(void) -> bool;
+	inline auto RecordDrawLatency(const RDFCommon::callsign_position& drawPosition) -> void { engine.RecordDrawLatency(drawPosition); }
+
+	// plugin_host
+	virtual auto SelectRadarTarget(const std::string& callsign) -> std::optional<RDFCommon::target_data>;
+	virtual auto SelectController(const std::string& callsign) -> std::optional<RDFCommon::geo_position>;
+	virtual auto EnumerateChannels(std::vector<RDFCommon::chnl_entry>& channels) -> void;
+	virtual auto GetChannelSignature(void) -> RDFCommon::chnl_signature;
+	virtual auto IsChannel(const size_t& handle, const std::string& name) -> bool;
+	virtual auto GetChannelState(const size_t& handle) -> std::optional<RDFCommon::chnl_state>;
+	virtual auto ToggleTextReceive(const size_t& handle) -> void;
+	virtual auto ToggleTextTransmit(const size_t& handle) -> void;
+	virtual auto GetSetting(const std::string& name) -> std::optional<std::string>;
+	virtual auto SaveSetting(const std::string& name, const std::string& description, const std::string& value) -> void;
+	virtual auto DisplayMessage(const RDFCommon::message_level& level, const std::string& msg) -> void;
+	virtual auto IsDirectConnection(void) -> bool;
+
+	// EuroScope
+	virtual auto OnTimer(int Counter) -> void;
+	virtual auto OnRadarScreenCreated(const char* sDisplayName, bool NeedRadarContent, bool GeoReferenced, bool CanBeSaved, bool CanBeCreated) -> EuroScopePlugIn::CRadarScreen*;
+	virtual auto OnCompileCommand(const char* sCommandLine) -> bool;
+	virtual auto OnControllerPositionUpdate(EuroScopePlugIn::CController Controller) -> void;
+	virtual auto OnControllerDisconnect(EuroScopePlugIn::CController Controller) -> void;
+	virtual auto OnFlightPlanDisconnect(EuroScopePlugIn::CFlightPlan FlightPlan) -> void;
+	virtual auto OnRadarTargetPositionUpdate(EuroScopePlugIn::CRadarTarget RadarTarget) -> void;
+	virtual auto OnGetTagItem(EuroScopePlugIn::CFlightPlan FlightPlan, EuroScopePlugIn::CRadarTarget RadarTarget, int ItemCode, int TagData, char sItemString[16], int* pColorCode, COLORREF* pRGB, double* pFontSize) -> void;
+};
+
+#endif // !CRDFPLUGIN_H
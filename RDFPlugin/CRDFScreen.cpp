@@ -1,231 +1,416 @@
-#pragma once
-
-#include "stdafx.h"
-#include "CRDFScreen.h"
-
-CRDFScreen::CRDFScreen(std::weak_ptr<CRDFPlugin> plugin, const int& ID)
-{
-	m_Plugin = plugin;
-	m_ID = ID;
-	m_Opened = false;
-	PLOGI << "created, ID: " << m_ID;
-}
-
-CRDFScreen::~CRDFScreen()
-{
-	PLOGI << "screen destroyed, ID: " << m_ID;
-}
-
-auto CRDFScreen::OnAsrContentLoaded(bool Loaded) -> void
-{
-	m_Opened = true;
-	PLOGI << "content loaded, ID: " << m_ID;
-}
-
-auto CRDFScreen::OnAsrContentToBeClosed(void) -> void
-{
-	m_Opened = false; // should not delete this to avoid crash
-	PLOGI << "screen closed, ID " << m_ID;
-}
-
-auto CRDFScreen::OnRefresh(HDC hDC, int Phase) -> void
-{
-	if (!m_Opened) return;
-	if (Phase == EuroScopePlugIn::REFRESH_PHASE_BACK_BITMAP) {
-		PLOGD << "updating screen, ID: " << m_ID;
-		m_Plugin.lock()->LoadDrawingSettings(shared_from_this());
-		return;
-	}
-	if (Phase != EuroScopePlugIn::REFRESH_PHASE_AFTER_TAGS) return;
-
-	RDFCommon::callsign_position drawPosition = m_Plugin.lock()->GetDrawStations();
-	if (drawPosition.empty()) {
-		return;
-	}
-
-	PLOGV << "drawing RDF";
-	std::shared_lock dlock(m_Plugin.lock()->mtxDrawSettings); // prevent accidental modification
-	const RDFCommon::draw_settings params = *m_Plugin.lock()->currentDrawSettings;
-	dlock.unlock();
-
-	HGDIOBJ oldBrush = SelectObject(hDC, GetStockObject(HOLLOW_BRUSH));
-	COLORREF penColor = drawPosition.size() > 1 ? params.rdfConcurRGB : params.rdfRGB;
-	HPEN hPen = CreatePen(PS_SOLID, 1, penColor);
-	HGDIOBJ oldPen = SelectObject(hDC, hPen);
-
-	for (auto& callsignPos : drawPosition) {
-		POINT pPos = ConvertCoordFromPositionToPixel(callsignPos.second.position);
-		if (PlaneIsVisible(pPos, GetRadarArea())) {
-			double drawR = callsignPos.second.radius;
-			// deal with drawing radius when threshold enabled
-			if (params.circleThreshold >= 0) {
-				EuroScopePlugIn::CPosition posLD, posRU;
-				GetDisplayArea(&posLD, &posRU);
-				POINT pLD = ConvertCoordFromPositionToPixel(posLD);
-				POINT pRU = ConvertCoordFromPositionToPixel(posRU);
-				double dst = sqrt(pow(pRU.x - pLD.x, 2) + pow(pRU.y - pLD.y, 2));
-				drawR = drawR * dst / posLD.DistanceTo(posRU);
-			}
-			if (drawR >= (double)params.circleThreshold) {
-				// draw circle
-				if (params.circleThreshold >= 0) {
-					// using position as boundary xy
-					EuroScopePlugIn::CPosition pl = callsignPos.second.position;
-					RDFCommon::AddOffset(pl, 270, callsignPos.second.radius);
-					EuroScopePlugIn::CPosition pt = callsignPos.second.position;
-					RDFCommon::AddOffset(pt, 0, callsignPos.second.radius);
-					EuroScopePlugIn::CPosition pr = callsignPos.second.position;
-					RDFCommon::AddOffset(pr, 90, callsignPos.second.radius);
-					EuroScopePlugIn::CPosition pb = callsignPos.second.position;
-					RDFCommon::AddOffset(pb, 180, callsignPos.second.radius);
-					Ellipse(hDC,
-						ConvertCoordFromPositionToPixel(pl).x,
-						ConvertCoordFromPositionToPixel(pt).y,
-						ConvertCoordFromPositionToPixel(pr).x,
-						ConvertCoordFromPositionToPixel(pb).y
-					);
-				}
-				else {
-					// using pixel as boundary xy
-					Ellipse(hDC, pPos.x - (int)round(drawR), pPos.y - (int)round(drawR), pPos.x + (int)round(drawR), pPos.y + (int)round(drawR));
-				}
-				continue;
-			}
-		}
-		// draw line
-		POINT oldPoint;
-		MoveToEx(hDC, (GetRadarArea().right - GetRadarArea().left) / 2, (GetRadarArea().bottom - GetRadarArea().top) / 2, &oldPoint);
-		LineTo(hDC, pPos.x, pPos.y);
-		MoveToEx(hDC, oldPoint.x, oldPoint.y, NULL);
-	}
-
-	SelectObject(hDC, oldBrush);
-	SelectObject(hDC, oldPen);
-	DeleteObject(hPen);
-	PLOGV << "draw complete";
-}
-
-auto CRDFScreen::OnCompileCommand(const char* sCommandLine) -> bool
-{
-	try
-	{
-		PLOGD << "(ID: " << m_ID << ") " << sCommandLine;
-		std::string cmd = sCommandLine;
-		std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::toupper);
-		bool asr = false;
-		static const std::string COMMAND_ASR = ".RDF ASR ";
-		static const std::string COMMAND_PLUGIN = ".RDF ";
-		if (cmd.starts_with(COMMAND_ASR)) { // test per-ASR
-			cmd = cmd.substr(COMMAND_ASR.size());
-			PLOGV << "matching ASR config";
-			asr = true;
-		}
-		else if (cmd.starts_with(COMMAND_PLUGIN)) {
-			cmd = cmd.substr(COMMAND_PLUGIN.size());
-			PLOGV << "matching plugin config";
-		}
-		else {
-			return false;
-		}
-		// match config
-		std::smatch match;
-		std::regex rxDraw(R"(^DRAW (ON|OFF)$)", std::regex_constants::icase);
-		if (std::regex_match(cmd, match, rxDraw)) {
-			bool mode = match[1].str() == "ON";
-			SaveDrawSetting(SETTING_ENABLE_DRAW, "Enable RDF draw", std::to_string(mode), asr);
-			return true;
-		}
-		std::regex rxRGB(R"(^(RGB|CTRGB) (\S+)$)", std::regex_constants::icase);
-		if (std::regex_match(cmd, match, rxRGB)) {
-			auto bufferMode = match[1].str();
-			auto bufferRGB = match[2].str();
-			std::transform(bufferMode.begin(), bufferMode.end(), bufferMode.begin(), ::toupper);
-			COLORREF _rgb = RGB(0, 0, 0);
-			if (RDFCommon::GetRGB(_rgb, bufferRGB)) {
-				if (bufferMode == "RGB") {
-					SaveDrawSetting(SETTING_RGB, "RGB", bufferRGB, asr);
-				}
-				else {
-					SaveDrawSetting(SETTING_CONCURRENT_RGB, "Concurrent RGB", bufferRGB, asr);
-				}
-				return true;
-			}
-		}
-		// no need for regex
-		int bufferRadius;
-		if (sscanf_s(cmd.c_str(), "RADIUS %d", &bufferRadius) == 1) {
-			if (bufferRadius > 0) {
-				SaveDrawSetting(SETTING_CIRCLE_RADIUS, "Radius", std::to_string(bufferRadius), asr);
-				return true;
-			}
-		}
-		int bufferThreshold;
-		if (sscanf_s(cmd.c_str(), "THRESHOLD %d", &bufferThreshold) == 1) {
-			SaveDrawSetting(SETTING_THRESHOLD, "Threshold", std::to_string(bufferThreshold), asr);
-			return true;
-		}
-		int bufferAltitude;
-		if (sscanf_s(cmd.c_str(), "ALTITUDE L%d", &bufferAltitude) == 1) {
-			SaveDrawSetting(SETTING_LOW_ALTITUDE, "Altitude (low)", std::to_string(bufferAltitude), asr);
-			return true;
-		}
-		if (sscanf_s(cmd.c_str(), "ALTITUDE H%d", &bufferAltitude) == 1) {
-			SaveDrawSetting(SETTING_HIGH_ALTITUDE, "Altitude (high)", std::to_string(bufferAltitude), asr);
-			return true;
-		}
-		int bufferPrecision;
-		if (sscanf_s(cmd.c_str(), "PRECISION L%d", &bufferPrecision) == 1) {
-			if (bufferPrecision >= 0) {
-				SaveDrawSetting(SETTING_LOW_PRECISION, "Precision (low)", std::to_string(bufferPrecision), asr);
-				return true;
-			}
-		}
-		if (sscanf_s(cmd.c_str(), "PRECISION H%d", &bufferPrecision) == 1) {
-			if (bufferPrecision >= 0) {
-				SaveDrawSetting(SETTING_HIGH_PRECISION, "Precision (high)", std::to_string(bufferPrecision), asr);
-				return true;
-			}
-		}
-		if (sscanf_s(cmd.c_str(), "PRECISION %d", &bufferPrecision) == 1) {
-			if (bufferPrecision >= 0) {
-				SaveDrawSetting(SETTING_PRECISION, "Precision", std::to_string(bufferPrecision), asr);
-				return true;
-			}
-		}
-		int bufferCtrl;
-		if (sscanf_s(cmd.c_str(), "CONTROLLER %d", &bufferCtrl) == 1) {
-			SaveDrawSetting(SETTING_DRAW_CONTROLLERS, "Draw controllers", std::to_string(bufferCtrl), asr);
-			return true;
-		}
-	}
-	catch (std::exception const& e)
-	{
-		PLOGE << "Error: " << e.what();
-		m_Plugin.lock()->DisplayMessageUnread(std::string("Error: ") + e.what());
-	}
-	catch (...) {
-		PLOGE << UNKNOWN_ERROR_MSG;
-		m_Plugin.lock()->DisplayMessageUnread(UNKNOWN_ERROR_MSG);
-	}
-	return false;
-}
-
-auto CRDFScreen::PlaneIsVisible(const POINT& p, const RECT& radarArea) -> bool
-{
-	return p.x >= radarArea.left && p.x <= radarArea.right && p.y >= radarArea.top && p.y <= radarArea.bottom;
-}
-
-auto CRDFScreen::SaveDrawSetting(const std::string& varName, const std::string& varDescr, const std::string& val, const bool& useAsr) -> void
-{
-	std::string logMsg;
-	if (useAsr) {
-		SaveDataToAsr(varName.c_str(), varDescr.c_str(), val.c_str());
-		logMsg = std::format("ASR configurations, {}: {}", varName, val);
-	}
-	else {
-		m_Plugin.lock()->SaveDataToSettings(varName.c_str(), varDescr.c_str(), val.c_str());
-		logMsg = std::format("Plugin configurations, {}: {}", varName, val);
-	}
-	PLOGI << logMsg;
-	m_Plugin.lock()->DisplayMessageSilent(logMsg);
-}
+#pragma once
+
+#include "stdafx.h"
+#include "CRDFScreen.h"
+
+CRDFScreen::CRDFScreen(std::weak_ptr<CRDFPlugin> plugin, const int& ID)
+{
+	m_Plugin = plugin;
+	m_ID = ID;
+	m_Opened = false;
+	PLOGI << "created, ID: " << m_ID;
+}
+
+CRDFScreen::~CRDFScreen()
+{
+	ReleaseLayer();
+	for (auto& [key, pen] : m_PenCache) {
+		DeleteObject(pen);
+	}
+	PLOGI << "screen destroyed, ID: " << m_ID;
+}
+
+auto CRDFScreen::OnAsrContentLoaded(bool Loaded) -> void
+{
+	m_Opened = true;
+	PLOGI << "content loaded, ID: " << m_ID;
+	UpdateDrawingSettings();
+}
+
+auto CRDFScreen::OnAsrContentToBeClosed(void) -> void
+{
+	m_Opened = false; // should not delete this to avoid crash
+	PLOGI << "screen closed, ID " << m_ID;
+}
+
+auto CRDFScreen::OnRefresh(HDC hDC, int Phase) -> void
+{
+	if (!m_Opened) return;
+	if (Phase == EuroScopePlugIn::REFRESH_PHASE_BEFORE_TAGS) {
+		// drain once per refresh cycle, right before records are drawn
+		m_Plugin.lock()->ProcessEvents();
+		return;
+	}
+	if (Phase == EuroScopePlugIn::REFRESH_PHASE_BACK_BITMAP) {
+		RDF_TRACE_SCOPE("OnRefresh BACK_BITMAP");
+		PLOGD << "updating screen, ID: " << m_ID;
+		m_Plugin.lock()->SetDrawingSettings(m_DrawSettings);
+		return;
+	}
+	if (Phase != EuroScopePlugIn::REFRESH_PHASE_AFTER_TAGS) return;
+	RDF_TRACE_SCOPE("OnRefresh AFTER_TAGS");
+
+	auto drawPosition = m_Plugin.lock()->GetDrawStations();
+	if (drawPosition->empty()) {
+		return;
+	}
+
+	m_GdiObjectsCreated = 0;
+	bool changed;
+	{
+		RDF_TRACE_SCOPE("UpdateDrawList");
+		changed = UpdateDrawList(drawPosition);
+	}
+	if (changed) {
+		m_Plugin.lock()->RecordDrawLatency(*drawPosition);
+	}
+	if (m_DrawSettings->cachedLayer) {
+		if (changed || !m_LayerValid) {
+			RenderLayer(hDC);
+		}
+		if (m_LayerValid) {
+			PLOGV << "compositing RDF layer";
+			BLENDFUNCTION blend = { AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+			AlphaBlend(hDC, 0, 0, m_LayerSize.cx, m_LayerSize.cy, m_LayerDC, 0, 0, m_LayerSize.cx, m_LayerSize.cy, blend);
+			return;
+		}
+	}
+	else if (m_LayerDC != NULL) {
+		ReleaseLayer();
+	}
+
+	PLOGV << "drawing RDF";
+	DrawPrimitives(hDC, m_DrawList.color);
+	PLOGV << "draw complete, GDI objects created: " << m_GdiObjectsCreated;
+}
+
+auto CRDFScreen::DrawPrimitives(HDC hDC, const COLORREF& color) -> void
+{
+	HGDIOBJ oldBrush = SelectObject(hDC, GetStockObject(HOLLOW_BRUSH));
+	HGDIOBJ oldPen = SelectObject(hDC, GetPen(color, 1));
+
+	if (m_DrawList.ellipses.size()) {
+		// stroke all fixed pixel circles at once
+		BeginPath(hDC);
+		for (auto& rect : m_DrawList.ellipses) {
+			Ellipse(hDC, rect.left, rect.top, rect.right, rect.bottom);
+		}
+		EndPath(hDC);
+		StrokePath(hDC);
+	}
+	if (m_DrawList.ringCounts.size()) {
+		PolyPolygon(hDC, m_DrawList.ringPoints.data(), m_DrawList.ringCounts.data(), (int)m_DrawList.ringCounts.size());
+	}
+	if (m_DrawList.lineCounts.size()) {
+		PolyPolyline(hDC, m_DrawList.lines.data(), m_DrawList.lineCounts.data(), (DWORD)m_DrawList.lineCounts.size());
+	}
+
+	SelectObject(hDC, oldBrush);
+	SelectObject(hDC, oldPen);
+}
+
+auto CRDFScreen::RenderLayer(HDC hDC) -> void
+{
+	// draw white mask into cleared DIB, then colorize drawn pixels as opaque
+	m_LayerValid = false;
+	SIZE size = { m_DrawRadarArea.right, m_DrawRadarArea.bottom };
+	if (size.cx <= 0 || size.cy <= 0) return;
+	if (m_LayerDC == NULL || size.cx != m_LayerSize.cx || size.cy != m_LayerSize.cy) {
+		ReleaseLayer();
+		BITMAPINFO bmi = {};
+		bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+		bmi.bmiHeader.biWidth = size.cx;
+		bmi.bmiHeader.biHeight = -size.cy; // top-down
+		bmi.bmiHeader.biPlanes = 1;
+		bmi.bmiHeader.biBitCount = 32;
+		bmi.bmiHeader.biCompression = BI_RGB;
+		void* bits = nullptr;
+		m_LayerDC = CreateCompatibleDC(hDC);
+		m_LayerBitmap = m_LayerDC != NULL ? CreateDIBSection(m_LayerDC, &bmi, DIB_RGB_COLORS, &bits, NULL, 0) : NULL;
+		if (m_LayerBitmap == NULL || bits == nullptr) {
+			PLOGE << "unable to create RDF layer, ID: " << m_ID;
+			ReleaseLayer();
+			return;
+		}
+		m_GdiObjectsCreated += 2;
+		m_LayerOldBitmap = SelectObject(m_LayerDC, m_LayerBitmap);
+		m_LayerBits = static_cast<DWORD*>(bits);
+		m_LayerSize = size;
+		PLOGD << "RDF layer created, ID: " << m_ID << ", size: " << size.cx << "x" << size.cy;
+	}
+	PLOGV << "rendering RDF layer, ID: " << m_ID;
+	size_t pixels = (size_t)m_LayerSize.cx * (size_t)m_LayerSize.cy;
+	std::fill_n(m_LayerBits, pixels, 0);
+	DrawPrimitives(m_LayerDC, RGB(255, 255, 255));
+	GdiFlush();
+	// BGRA, premultiplied
+	DWORD pixel = 0xFF000000 | ((DWORD)GetRValue(m_DrawList.color) << 16) | ((DWORD)GetGValue(m_DrawList.color) << 8) | (DWORD)GetBValue(m_DrawList.color);
+	for (size_t i = 0; i < pixels; i++) {
+		if (m_LayerBits[i]) {
+			m_LayerBits[i] = pixel;
+		}
+	}
+	m_LayerValid = true;
+}
+
+auto CRDFScreen::ReleaseLayer(void) -> void
+{
+	if (m_LayerDC != NULL) {
+		if (m_LayerOldBitmap != NULL) {
+			SelectObject(m_LayerDC, m_LayerOldBitmap);
+		}
+		DeleteDC(m_LayerDC);
+	}
+	if (m_LayerBitmap != NULL) {
+		DeleteObject(m_LayerBitmap);
+	}
+	m_LayerDC = NULL;
+	m_LayerBitmap = NULL;
+	m_LayerOldBitmap = NULL;
+	m_LayerBits = nullptr;
+	m_LayerSize = { 0, 0 };
+	m_LayerValid = false;
+}
+
+auto CRDFScreen::GetPen(const COLORREF& color, const int& width) -> HPEN
+{
+	auto it = m_PenCache.find({ color, width });
+	if (it != m_PenCache.end()) {
+		return it->second;
+	}
+	HPEN hPen = CreatePen(PS_SOLID, width, color);
+	m_GdiObjectsCreated++;
+	m_PenCache.emplace(std::make_pair(color, width), hPen);
+	return hPen;
+}
+
+auto CRDFScreen::UpdateDrawList(const std::shared_ptr<const RDFCommon::callsign_position>& drawPosition) -> bool
+{
+	// re-project only when records, settings or view changed, otherwise keep retained primitives
+	EuroScopePlugIn::CPosition posLD, posRU;
+	GetDisplayArea(&posLD, &posRU);
+	RECT radarArea = GetRadarArea();
+	bool recordsChanged = drawPosition != m_DrawRecords || m_DrawSettings != m_DrawListSettings;
+	bool viewChanged = posLD.m_Latitude != m_DrawAreaLD.m_Latitude || posLD.m_Longitude != m_DrawAreaLD.m_Longitude ||
+		posRU.m_Latitude != m_DrawAreaRU.m_Latitude || posRU.m_Longitude != m_DrawAreaRU.m_Longitude ||
+		radarArea.left != m_DrawRadarArea.left || radarArea.top != m_DrawRadarArea.top ||
+		radarArea.right != m_DrawRadarArea.right || radarArea.bottom != m_DrawRadarArea.bottom;
+	if (!recordsChanged && !viewChanged) return false;
+
+	const RDFCommon::draw_settings& params = *m_DrawSettings;
+	if (recordsChanged) {
+		PLOGV << "updating geodetic circles, ID: " << m_ID;
+		m_DrawRecords = drawPosition;
+		m_DrawListSettings = m_DrawSettings;
+		m_DrawStations.clear();
+		for (auto& callsignPos : *drawPosition) {
+			RDFCommon::draw_station station;
+			station.position = callsignPos.second.position;
+			station.radius = callsignPos.second.radius;
+			m_DrawStations.push_back(station); // rings are generated on projection when LOD is known
+		}
+	}
+	m_DrawAreaLD = posLD;
+	m_DrawAreaRU = posRU;
+	m_DrawRadarArea = radarArea;
+
+	PLOGV << "projecting draw list, ID: " << m_ID;
+	m_DrawList.color = m_DrawStations.size() > 1 ? params.rdfConcurRGB : params.rdfRGB;
+	POINT lineOrigin = { (radarArea.right - radarArea.left) / 2, (radarArea.bottom - radarArea.top) / 2 };
+	m_DrawList.ellipses.clear();
+	m_DrawList.ringPoints.clear();
+	m_DrawList.ringCounts.clear();
+	m_DrawList.lines.clear();
+	m_DrawList.lineCounts.clear();
+	// pixels per nautical mile, only used when threshold enabled
+	double scale = 0;
+	if (params.circleThreshold >= 0) {
+		POINT pLD = ConvertCoordFromPositionToPixel(posLD);
+		POINT pRU = ConvertCoordFromPositionToPixel(posRU);
+		double dst = sqrt(pow(pRU.x - pLD.x, 2) + pow(pRU.y - pLD.y, 2));
+		scale = dst / posLD.DistanceTo(posRU);
+	}
+	for (auto& station : m_DrawStations) {
+		POINT pPos = ConvertCoordFromPositionToPixel(RDFCommon::ToPosition(station.position));
+		if (PlaneIsVisible(pPos, radarArea)) {
+			double drawR = station.radius;
+			// deal with drawing radius when threshold enabled
+			if (params.circleThreshold >= 0) {
+				drawR = drawR * scale;
+			}
+			if (drawR >= (double)params.circleThreshold) {
+				// draw circle
+				if (params.circleThreshold >= 0) {
+					// geodesic ring, vertex count bounded by LOD
+					size_t level = RDFCommon::RingLodLevel(drawR);
+					if (station.ringLevel != level) {
+						RDFCommon::AddRing(station.position, station.radius, RDFCommon::GetRingLod(level), station.ring);
+						station.ringLevel = level;
+					}
+					for (auto& pos : station.ring) {
+						m_DrawList.ringPoints.push_back(ConvertCoordFromPositionToPixel(RDFCommon::ToPosition(pos)));
+					}
+					m_DrawList.ringCounts.push_back((INT)station.ring.size());
+				}
+				else {
+					// using pixel as boundary xy
+					m_DrawList.ellipses.push_back({
+						pPos.x - (int)round(drawR),
+						pPos.y - (int)round(drawR),
+						pPos.x + (int)round(drawR),
+						pPos.y + (int)round(drawR)
+						});
+				}
+				continue;
+			}
+		}
+		// draw line
+		m_DrawList.lines.push_back(lineOrigin);
+		m_DrawList.lines.push_back(pPos);
+		m_DrawList.lineCounts.push_back(2);
+	}
+	return true;
+}
+
+auto CRDFScreen::OnCompileCommand(const char* sCommandLine) -> bool
+{
+	try
+	{
+		PLOGD << "(ID: " << m_ID << ") " << sCommandLine;
+		std::string cmd = sCommandLine;
+		std::transform(cmd.begin(), cmd.end(), cmd.begin(), ::toupper);
+		bool asr = false;
+		static const std::string COMMAND_ASR = ".RDF ASR ";
+		static const std::string COMMAND_PLUGIN = ".RDF ";
+		if (cmd.starts_with(COMMAND_ASR)) { // test per-ASR
+			cmd = cmd.substr(COMMAND_ASR.size());
+			PLOGV << "matching ASR config";
+			asr = true;
+		}
+		else if (cmd.starts_with(COMMAND_PLUGIN)) {
+			cmd = cmd.substr(COMMAND_PLUGIN.size());
+			PLOGV << "matching plugin config";
+		}
+		else {
+			return false;
+		}
+		// match config
+		std::smatch match;
+		std::regex rxDraw(R"(^DRAW (ON|OFF)$)", std::regex_constants::icase);
+		if (std::regex_match(cmd, match, rxDraw)) {
+			bool mode = match[1].str() == "ON";
+			SaveDrawSetting(SETTING_ENABLE_DRAW, "Enable RDF draw", std::to_string(mode), asr);
+			return true;
+		}
+		std::regex rxRGB(R"(^(RGB|CTRGB) (\S+)$)", std::regex_constants::icase);
+		if (std::regex_match(cmd, match, rxRGB)) {
+			auto bufferMode = match[1].str();
+			auto bufferRGB = match[2].str();
+			std::transform(bufferMode.begin(), bufferMode.end(), bufferMode.begin(), ::toupper);
+			COLORREF _rgb = RGB(0, 0, 0);
+			if (RDFCommon::GetRGB(_rgb, bufferRGB)) {
+				if (bufferMode == "RGB") {
+					SaveDrawSetting(SETTING_RGB, "RGB", bufferRGB, asr);
+				}
+				else {
+					SaveDrawSetting(SETTING_CONCURRENT_RGB, "Concurrent RGB", bufferRGB, asr);
+				}
+				return true;
+			}
+		}
+		// no need for regex
+		int bufferRadius;
+		if (sscanf_s(cmd.c_str(), "RADIUS %d", &bufferRadius) == 1) {
+			if (bufferRadius > 0) {
+				SaveDrawSetting(SETTING_CIRCLE_RADIUS, "Radius", std::to_string(bufferRadius), asr);
+				return true;
+			}
+		}
+		int bufferThreshold;
+		if (sscanf_s(cmd.c_str(), "THRESHOLD %d", &bufferThreshold) == 1) {
+			SaveDrawSetting(SETTING_THRESHOLD, "Threshold", std::to_string(bufferThreshold), asr);
+			return true;
+		}
+		int bufferAltitude;
+		if (sscanf_s(cmd.c_str(), "ALTITUDE L%d", &bufferAltitude) == 1) {
+			SaveDrawSetting(SETTING_LOW_ALTITUDE, "Altitude (low)", std::to_string(bufferAltitude), asr);
+			return true;
+		}
+		if (sscanf_s(cmd.c_str(), "ALTITUDE H%d", &bufferAltitude) == 1) {
+			SaveDrawSetting(SETTING_HIGH_ALTITUDE, "Altitude (high)", std::to_string(bufferAltitude), asr);
+			return true;
+		}
+		int bufferPrecision;
+		if (sscanf_s(cmd.c_str(), "PRECISION L%d", &bufferPrecision) == 1) {
+			if (bufferPrecision >= 0) {
+				SaveDrawSetting(SETTING_LOW_PRECISION, "Precision (low)", std::to_string(bufferPrecision), asr);
+				return true;
+			}
+		}
+		if (sscanf_s(cmd.c_str(), "PRECISION H%d", &bufferPrecision) == 1) {
+			if (bufferPrecision >= 0) {
+				SaveDrawSetting(SETTING_HIGH_PRECISION, "Precision (high)", std::to_string(bufferPrecision), asr);
+				return true;
+			}
+		}
+		if (sscanf_s(cmd.c_str(), "PRECISION %d", &bufferPrecision) == 1) {
+			if (bufferPrecision >= 0) {
+				SaveDrawSetting(SETTING_PRECISION, "Precision", std::to_string(bufferPrecision), asr);
+				return true;
+			}
+		}
+		int bufferCtrl;
+		if (sscanf_s(cmd.c_str(), "CONTROLLER %d", &bufferCtrl) == 1) {
+			SaveDrawSetting(SETTING_DRAW_CONTROLLERS, "Draw controllers", std::to_string(bufferCtrl), asr);
+			return true;
+		}
+		int bufferLayer;
+		if (sscanf_s(cmd.c_str(), "LAYER %d", &bufferLayer) == 1) {
+			SaveDrawSetting(SETTING_CACHED_LAYER, "Cached layer", std::to_string(bufferLayer), asr);
+			return true;
+		}
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+		m_Plugin.lock()->DisplayMessageUnread(std::string("Error: ") + e.what());
+	}
+	catch (...) {
+		PLOGE << UNKNOWN_ERROR_MSG;
+		m_Plugin.lock()->DisplayMessageUnread(UNKNOWN_ERROR_MSG);
+	}
+	return false;
+}
+
+auto CRDFScreen::PlaneIsVisible(const POINT& p, const RECT& radarArea) -> bool
+{
+	return p.x >= radarArea.left && p.x <= radarArea.right && p.y >= radarArea.top && p.y <= radarArea.bottom;
+}
+
+auto CRDFScreen::SaveDrawSetting(const std::string& varName, const std::string& varDescr, const std::string& val, const bool& useAsr) -> void
+{
+	std::string logMsg;
+	if (useAsr) {
+		SaveDataToAsr(varName.c_str(), varDescr.c_str(), val.c_str());
+		logMsg = std::format("ASR configurations, {}: {}", varName, val);
+	}
+	else {
+		m_Plugin.lock()->SaveDataToSettings(varName.c_str(), varDescr.c_str(), val.c_str());
+		logMsg = std::format("Plugin configurations, {}: {}", varName, val);
+	}
+	PLOGI << logMsg;
+	m_Plugin.lock()->DisplayMessageSilent(logMsg);
+	// plugin settings may be inherited by every screen
+	if (useAsr) {
+		UpdateDrawingSettings();
+	}
+	else {
+		m_Plugin.lock()->ReloadDrawingSettings();
+	}
+}
+
+auto CRDFScreen::UpdateDrawingSettings(void) -> void
+{
+	PLOGD << "compiling drawing settings, ID: " << m_ID;
+	m_DrawSettings = m_Plugin.lock()->LoadDrawingSettings(shared_from_this());
+}
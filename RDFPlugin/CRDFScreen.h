@@ -1,33 +1,60 @@
-#pragma once
-
-#ifndef CRDFSCREEN_H
-#define CRDFSCREEN_H
-
-#include "stdafx.h"
-#include "CRDFPlugin.h"
-
-class CRDFScreen : public EuroScopePlugIn::CRadarScreen, public std::enable_shared_from_this<CRDFScreen>
-{
-private:
-	friend class CRDFPlugin;
-
-	std::weak_ptr<CRDFPlugin> m_Plugin;
-	int m_ID;
-
-	auto PlaneIsVisible(const POINT& p, const RECT& radarArea) -> bool;
-	auto SaveDrawSetting(const std::string& varName, const std::string& varDescr, const std::string& val, const bool& useAsr) -> void;
-
-public:
-	CRDFScreen(std::weak_ptr<CRDFPlugin> plugin, const int& ID);
-	~CRDFScreen(void);
-
-	bool m_Opened;
-
-	virtual auto OnAsrContentLoaded(bool Loaded) -> void;
-	virtual auto OnAsrContentToBeClosed(void) -> void;
-	virtual auto OnRefresh(HDC hDC, int Phase) -> void;
-	virtual auto OnCompileCommand(const char* sCommandLine) -> bool;
-
-};
-
-#endif // !CRDFSCREEN_H
+#pragma once
+
+#ifndef CRDFSCREEN_H
+#define CRDFSCREEN_H
+
+#include "stdafx.h"
+#include "CRDFPlugin.h"
+
+class CRDFScreen : public EuroScopePlugIn::CRadarScreen, public std::enable_shared_from_this<CRDFScreen>
+{
+private:
+	friend class CRDFPlugin;
+
+	std::weak_ptr<CRDFPlugin> m_Plugin;
+	int m_ID;
+	std::shared_ptr<const RDFCommon::draw_settings> m_DrawSettings; // compiled profile, rebuilt only on changes
+
+	// retained drawing, keyed by records, settings and view
+	std::shared_ptr<const RDFCommon::callsign_position> m_DrawRecords; // held to keep identity
+	std::shared_ptr<const RDFCommon::draw_settings> m_DrawListSettings;
+	std::vector<RDFCommon::draw_station> m_DrawStations;
+	EuroScopePlugIn::CPosition m_DrawAreaLD, m_DrawAreaRU;
+	RECT m_DrawRadarArea = { 0, 0, 0, 0 };
+	RDFCommon::draw_list m_DrawList;
+
+	// GDI resources, kept for screen lifetime
+	std::map<std::pair<COLORREF, int>, HPEN> m_PenCache; // color & width
+	size_t m_GdiObjectsCreated = 0; // per frame
+	auto GetPen(const COLORREF& color, const int& width) -> HPEN;
+
+	// cached overlay layer, 32-bit premultiplied DIB section
+	HDC m_LayerDC = NULL;
+	HBITMAP m_LayerBitmap = NULL;
+	HGDIOBJ m_LayerOldBitmap = NULL;
+	DWORD* m_LayerBits = nullptr;
+	SIZE m_LayerSize = { 0, 0 };
+	bool m_LayerValid = false;
+	auto RenderLayer(HDC hDC) -> void;
+	auto ReleaseLayer(void) -> void;
+
+	auto PlaneIsVisible(const POINT& p, const RECT& radarArea) -> bool;
+	auto SaveDrawSetting(const std::string& varName, const std::string& varDescr, const std::string& val, const bool& useAsr) -> void;
+	auto UpdateDrawingSettings(void) -> void;
+	auto UpdateDrawList(const std::shared_ptr<const RDFCommon::callsign_position>& drawPosition) -> bool; // return true if changed
+	auto DrawPrimitives(HDC hDC, const COLORREF& color) -> void;
+
+public:
+	CRDFScreen(std::weak_ptr<CRDFPlugin> plugin, const int& ID);
+	~CRDFScreen(void);
+
+	bool m_Opened;
+
+	virtual auto OnAsrContentLoaded(bool Loaded) -> void;
+	virtual auto OnAsrContentToBeClosed(void) -> void;
+	virtual auto OnRefresh(HDC hDC, int Phase) -> void;
+	virtual auto OnCompileCommand(const char* sCommandLine) -> bool;
+
+};
+
+#endif // !CRDFSCREEN_H
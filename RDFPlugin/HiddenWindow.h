@@ -1,7 +1,7 @@
-#pragma once
-
-#include "stdafx.h"
-
-LRESULT CALLBACK HiddenWindowRDF(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
-
+#pragma once
+
+#include "stdafx.h"
+
+LRESULT CALLBACK HiddenWindowRDF(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
 LRESULT CALLBACK HiddenWindowAFV(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
\ No newline at end of file
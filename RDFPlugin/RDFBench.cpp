@@ -0,0 +1,249 @@
+#include "RDFBench.h"
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <nlohmann/json.hpp>
+
+static auto FormatComparison(const char* name, const double& fast, const char* referenceName, const double& reference) -> std::string
+{
+	std::ostringstream line;
+	line << std::fixed << std::setprecision(1) << name << ": " << fast << " ns, " << referenceName << ": " << reference
+		<< " ns, speedup " << std::setprecision(2) << (fast > 0 ? reference / fast : 0.0) << "x";
+	return line.str();
+}
+
+static auto BenchDecodeTrackAudioTransmission(const size_t& iterations) -> std::string
+{
+	// kRxBegin/kRxEnd as sent by TrackAudio, json parser is what TrackAudioMessageHandler falls back to
+	std::vector<std::string> frames;
+	for (size_t i = 0; i < 64; i++) {
+		frames.push_back(std::string(R"({"type":")") + (i % 2 ? "kRxEnd" : "kRxBegin") + R"(","value":{"callsign":"CPA)" +
+			std::to_string(100 + i) + R"(","pFrequencyHz":118700000}})");
+	}
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		RDFCommon::plugin_event event;
+		RDFCommon::DecodeTrackAudioTransmission(frames[i % frames.size()], event);
+		return event.message.size();
+		});
+	auto reference = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		auto data = nlohmann::json::parse(frames[i % frames.size()]);
+		std::string msgType = data["type"];
+		std::string callsign = data["value"].at("callsign");
+		return msgType.size() + callsign.size();
+		});
+	return FormatComparison("DecodeTrackAudioTransmission", fast, "json::parse", reference);
+}
+
+static auto BenchParseAFVStationState(const size_t& iterations) -> std::string
+{
+	// AFV bridge station states, reference is the getline & stod parser it replaced
+	std::vector<std::string> messages;
+	for (size_t i = 0; i < 64; i++) {
+		int frequency = 118000 + (int)(i * 25);
+		messages.push_back(std::to_string(frequency / 1000) + "." + std::to_string(1000 + frequency % 1000).substr(1) +
+			(i % 2 ? ":True" : ":False") + (i % 3 ? ":False" : ":True"));
+	}
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		RDFCommon::chnl_state state;
+		RDFCommon::ParseAFVStationState(messages[i % messages.size()], state);
+		return (size_t)state.frequency + state.rx + state.tx;
+		});
+	auto reference = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		std::queue<std::string> strings;
+		std::istringstream f(messages[i % messages.size()]);
+		std::string s;
+		while (std::getline(f, s, ':')) {
+			strings.push(s);
+		}
+		if (strings.size() != 3) return 0;
+		RDFCommon::chnl_state state;
+		state.frequency = FrequencyFromMHz(stod(strings.front()));
+		strings.pop();
+		state.rx = strings.front() == "True";
+		strings.pop();
+		state.tx = strings.front() == "True";
+		return (size_t)state.frequency + state.rx + state.tx;
+		});
+	return FormatComparison("ParseAFVStationState", fast, "getline & stod", reference);
+}
+
+static auto BenchFindChannel(const size_t& iterations) -> std::string
+{
+	// frequency lookup nearest prim among 50 channels, against copying the list into a name map per call as before indexing
+	std::vector<RDFCommon::chnl_entry> channels;
+	for (int i = 0; i < 50; i++) {
+		RDFCommon::chnl_state state;
+		state.frequency = 118000 + (i % 25) * 25;
+		state.isPrim = i == 20;
+		channels.push_back({ "STN_" + std::to_string(i), state, 0 });
+	}
+	auto index = RDFCommon::BuildChannelIndex(std::vector<RDFCommon::chnl_entry>(channels));
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		return RDFCommon::FindChannel(index, std::nullopt, 118000 + (int)(i % 25) * 25).value_or(0);
+		});
+	auto reference = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		int frequency = 118000 + (int)(i % 25) * 25;
+		std::map<std::string, RDFCommon::chnl_state> allChannels;
+		for (const auto& chnl : channels) {
+			allChannels[chnl.name] = chnl.state;
+		}
+		auto prim = std::find_if(allChannels.begin(), allChannels.end(), [](const auto& chnl) { return chnl.second.isPrim; });
+		auto primDistance = std::distance(allChannels.begin(), prim);
+		size_t best = 0;
+		auto bestDistance = std::numeric_limits<ptrdiff_t>::max();
+		for (auto it = allChannels.begin(); it != allChannels.end(); it++) {
+			auto distance = abs(primDistance - std::distance(allChannels.begin(), it));
+			if (FrequencyIsSame(it->second.frequency, frequency) && distance < bestDistance) {
+				bestDistance = distance;
+				best = it->first.size();
+			}
+		}
+		return best;
+		});
+	return FormatComparison("FindChannel", fast, "name map", reference);
+}
+
+static auto BenchAddOffsets(const size_t& iterations) -> std::string
+{
+	// 4 origins by 16 heading/distance pairs, against one AddOffset per pair
+#if defined(RDF_SIMD_AVX2)
+	constexpr auto name = "AddOffsets 4x16 (AVX2)";
+#elif defined(RDF_SIMD)
+	constexpr auto name = "AddOffsets 4x16 (SSE2)";
+#else
+	constexpr auto name = "AddOffsets 4x16 (scalar)";
+#endif
+	std::vector<RDFCommon::geo_position> origins = { { 22.3, 113.9 }, { 22.5, 114.1 }, { 21.9, 113.5 }, { 23.0, 114.8 } };
+	std::vector<RDFCommon::draw_offset> offsets;
+	for (size_t i = 0; i < 16; i++) {
+		offsets.push_back({ 22.5 * (double)i, 5.0 + (double)i });
+	}
+	std::vector<RDFCommon::geo_position> positions(origins.size() * offsets.size());
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		origins[0].latitude = 22.3 + (double)(i % 8) * 0.01;
+		RDFCommon::AddOffsets(origins, offsets, positions);
+		return (size_t)positions.back().latitude;
+		});
+	auto reference = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		origins[0].latitude = 22.3 + (double)(i % 8) * 0.01;
+		for (size_t o = 0; o < origins.size(); o++) {
+			for (size_t j = 0; j < offsets.size(); j++) {
+				positions[o * offsets.size() + j] = origins[o];
+				RDFCommon::AddOffset(positions[o * offsets.size() + j], offsets[j].bearing, offsets[j].distance);
+			}
+		}
+		return (size_t)positions.back().latitude;
+		});
+	return FormatComparison(name, fast, "AddOffset", reference);
+}
+
+static auto BenchAddRing(const size_t& iterations) -> std::string
+{
+	// 128 vertex ring at top LOD, against moving origin once per vertex
+	const RDFCommon::geo_position origin = { 22.3, 113.9 };
+	const auto& lod = RDFCommon::GetRingLod(RING_LOD_LEVELS - 1);
+	std::vector<RDFCommon::geo_position> ring;
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		RDFCommon::AddRing(origin, 20.0 + (double)(i % 8), lod, ring);
+		return ring.size();
+		});
+	auto reference = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		ring.assign(lod.sinBearing.size(), origin);
+		for (size_t v = 0; v < ring.size(); v++) {
+			RDFCommon::AddOffset(ring[v], 360.0 * (double)v / (double)ring.size(), 20.0 + (double)(i % 8));
+		}
+		return ring.size();
+		});
+	return FormatComparison("AddRing 128", fast, "AddOffset per vertex", reference);
+}
+
+static auto BenchCallsignLookup(const size_t& iterations) -> std::string
+{
+	// tag item lookup of a C string among 20 previous records, against building a string key into a map per call as before interning
+	RDFCommon::callsign_table table;
+	RDFCommon::callsign_position positions;
+	std::map<std::string, RDFCommon::draw_position> reference;
+	std::vector<std::string> callsigns;
+	for (size_t i = 0; i < 40; i++) {
+		callsigns.push_back("CPA" + std::to_string(100 + i * 7));
+		if (i % 2) {
+			RDFCommon::InsertPosition(positions, table.Intern(callsigns.back()), RDFCommon::draw_position());
+			reference[callsigns.back()] = RDFCommon::draw_position();
+		}
+	}
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		auto id = table.Find(callsigns[i % callsigns.size()].c_str());
+		return id && RDFCommon::FindPosition(positions, *id) != nullptr;
+		});
+	auto slow = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		std::string callsign = callsigns[i % callsigns.size()].c_str();
+		return reference.contains(callsign);
+		});
+	return FormatComparison("callsign lookup", fast, "std::map<std::string>", slow);
+}
+
+static auto BenchCopyRecords(const size_t& iterations) -> std::string
+{
+	// 20 records copied into each published snapshot, against string keyed map as before interning
+	RDFCommon::callsign_position positions;
+	std::map<std::string, RDFCommon::draw_position> reference;
+	for (RDFCommon::callsign_id i = 0; i < 20; i++) {
+		RDFCommon::InsertPosition(positions, i * 3, RDFCommon::draw_position());
+		reference["CPA" + std::to_string(100 + i * 3)] = RDFCommon::draw_position();
+	}
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t&) -> size_t {
+		RDFCommon::callsign_position copy(positions);
+		return copy.size();
+		});
+	auto slow = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t&) -> size_t {
+		std::map<std::string, RDFCommon::draw_position> copy(reference);
+		return copy.size();
+		});
+	return FormatComparison("copy 20 records", fast, "std::map<std::string>", slow);
+}
+
+static auto BenchTagItem(const size_t& iterations) -> std::string
+{
+	// tag item lookup of a C string among 20 previous records, hash set against table and shared snapshot as before
+	RDFCommon::callsign_table table;
+	RDFCommon::callsign_set set;
+	RDFCommon::callsign_position positions;
+	std::vector<std::string> callsigns;
+	std::vector<std::string_view> published;
+	for (size_t i = 0; i < 40; i++) {
+		callsigns.push_back("CPA" + std::to_string(100 + i * 7));
+	}
+	for (size_t i = 1; i < callsigns.size(); i += 2) {
+		RDFCommon::InsertPosition(positions, table.Intern(callsigns[i]), RDFCommon::draw_position());
+		published.push_back(callsigns[i]);
+	}
+	set.Publish(published);
+	std::atomic<std::shared_ptr<const RDFCommon::transmission_snapshot>> snapshot = std::make_shared<const RDFCommon::transmission_snapshot>(positions, positions, 1);
+	auto fast = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		return set.Contains(callsigns[i % callsigns.size()].c_str());
+		});
+	auto slow = RDFCommon::MeasureNanoseconds(iterations, [&](const size_t& i) -> size_t {
+		auto id = table.Find(callsigns[i % callsigns.size()].c_str());
+		return id && RDFCommon::FindPosition(snapshot.load()->previous, *id) != nullptr;
+		});
+	return FormatComparison("tag item", fast, "table and snapshot", slow);
+}
+
+auto RDFCommon::RunBenchmarks(const size_t& iterations) -> std::vector<std::string>
+{
+	std::vector<std::string> lines;
+	lines.push_back("Mean time per call over " + std::to_string(iterations) + " iterations.");
+	lines.push_back(BenchDecodeTrackAudioTransmission(iterations));
+	lines.push_back(BenchParseAFVStationState(iterations));
+	lines.push_back(BenchFindChannel(iterations));
+	lines.push_back(BenchAddOffsets(iterations));
+	lines.push_back(BenchAddRing(iterations));
+	lines.push_back(BenchCallsignLookup(iterations));
+	lines.push_back(BenchCopyRecords(iterations));
+	lines.push_back(BenchTagItem(iterations));
+	return lines;
+}
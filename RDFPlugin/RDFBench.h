@@ -0,0 +1,36 @@
+#pragma once
+
+#ifndef RDFBENCH_H
+#define RDFBENCH_H
+
+#include "RDFCore.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+constexpr auto BENCH_DEFAULT_ITERATIONS = 100000;
+
+namespace RDFCommon {
+
+	// Microbenchmarks of fast paths against the code they replaced, one line per result
+	auto RunBenchmarks(const size_t& iterations) -> std::vector<std::string>;
+
+	// Mean time of one call in ns, sink keeps results alive
+	template<typename F>
+	auto MeasureNanoseconds(const size_t& iterations, F&& fn) -> double
+	{
+		volatile size_t sink = 0;
+		for (size_t i = 0; i < iterations / 10 + 1; i++) { // warm up
+			sink = sink + fn(i);
+		}
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < iterations; i++) {
+			sink = sink + fn(i);
+		}
+		auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+		return iterations ? elapsed / (double)iterations : 0.0;
+	}
+
+}
+
+#endif // !RDFBENCH_H
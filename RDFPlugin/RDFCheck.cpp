@@ -0,0 +1,1172 @@
+#include "RDFCheck.h"
+#include "RDFEngine.h"
+#include "RDFQueue.h"
+#include "RDFReplay.h"
+#include "RDFStats.h"
+#include "RDFTrace.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+#include <nlohmann/json.hpp>
+
+#ifdef RDF_SELF_CHECK
+static auto CheckDecodeTrackAudioTransmission(void) -> bool
+{
+	// fast path must agree with json parser, or reject the frame and leave it to the parser
+	typedef struct _decode_case {
+		const char* message;
+		bool decoded;
+		RDFCommon::event_type type;
+		const char* callsign;
+	} decode_case;
+	constexpr auto begin = RDFCommon::event_type::TrackAudioRxBegin;
+	constexpr auto end = RDFCommon::event_type::TrackAudioRxEnd;
+	const decode_case cases[] = {
+		{ R"({"type":"kRxBegin","value":{"callsign":"CPA123","pFrequencyHz":118700000}})", true, begin, "CPA123" },
+		{ " {\"type\" : \"kRxEnd\",\n\"value\":{ \"callsign\":\"R\" }}\r\n", true, end, "R" },
+		{ R"({"value":{"callsign":"R"},"type":"kRxBegin"})", true, begin, "R" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","f":-1,"a":true,"b":false,"c":null,"d":{"callsign":"X"},"e":{}}})", true, begin, "R" },
+		{ R"({"type":"kRxEnd","value":{"callsign":"A","callsign":"B"},"type":"kRxBegin"})", true, begin, "B" }, // last duplicate wins
+		{ R"({"type":"kRxBegin","value":{"callsign":"R"},"value":{}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R"},"type":1})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":1}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"x":{"callsign":"R"}}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","f":118.7}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","f":1e5}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","f":0118}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","f":[1]}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","a":tru}})", false, begin, "" },
+		{ R"({"type":"kRxBegin" "value":{"callsign":"R"}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R"},})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R","d":{"d":{"d":{"d":{"d":{"d":{"d":{}}}}}}}}})", false, begin, "" },
+		{ "{\"type\":\"kRxBegin\",\"value\":{\"callsign\":\"R\xC3\xA9\"}}", false, begin, "" },
+		{ "{\"type\":\"kRxBegin\",\"value\":{\"callsign\":\"R\tX\"}}", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R"}} garbage)", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R"}}{"type":"kRxEnd","value":{"callsign":"R"}})", false, begin, "" },
+		{ R"(x{"type":"kRxBegin","value":{"callsign":"R"}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R"})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":"R\"X"}})", false, begin, "" },
+		{ R"({"type":"kRxBegin","value":{"callsign":""}})", false, begin, "" },
+		{ R"({"type":"kStationStateUpdate","value":{"callsign":"R"}})", false, begin, "" },
+		{ "", false, begin, "" }
+	};
+	bool passed = true;
+	for (const auto& c : cases) {
+		RDFCommon::plugin_event event;
+		bool decoded = RDFCommon::DecodeTrackAudioTransmission(c.message, event);
+		bool agreed = decoded == c.decoded && (!decoded || (event.type == c.type && event.message == c.callsign));
+		if (agreed && decoded) { // decoded frames must read the same through json parser
+			auto data = nlohmann::json::parse(c.message);
+			agreed = data.at("type") == (event.type == begin ? "kRxBegin" : "kRxEnd") && data.at("value").at("callsign") == event.message;
+		}
+		if (!agreed) {
+			PLOGE << "self check failed, DecodeTrackAudioTransmission: " << c.message;
+			passed = false;
+		}
+	}
+	return passed;
+}
+
+static auto SelectChannelReference(const std::vector<RDFCommon::chnl_entry>& channels, const std::optional<std::string>& callsign, const std::optional<int>& frequency) -> std::optional<size_t>
+{
+	// former SelectGroundToAirChannel on a channel list, walking it like EuroScope channels
+	// except that duplicated names are kept, instead of collapsing into the state of the last one
+	auto MatchName = [&](const size_t& i) -> bool {
+		return channels[i].name.find(*callsign) != std::string::npos;
+		};
+	auto MatchFrequency = [&](const size_t& i) -> bool {
+		return FrequencyIsSame(channels[i].state.frequency, *frequency);
+		};
+	if (callsign && frequency) {
+		for (size_t i = 0; i < channels.size(); i++) {
+			if (MatchName(i) && MatchFrequency(i)) return i;
+		}
+	}
+	else if (callsign) {
+		for (size_t i = 0; i < channels.size(); i++) {
+			if (MatchName(i)) return i;
+		}
+	}
+	if (frequency) {
+		std::set<std::string> names;
+		for (const auto& chnl : channels) {
+			names.insert(chnl.name);
+		}
+		auto primName = std::find_if(names.begin(), names.end(), [&](const auto& name) {
+			return std::any_of(channels.begin(), channels.end(), [&](const auto& chnl) { return chnl.name == name && chnl.state.isPrim; });
+			});
+		if (primName != names.end()) {
+			std::map<std::string, int> nameDistance;
+			auto primDistance = std::distance(names.begin(), primName);
+			for (size_t i = 0; i < channels.size(); i++) {
+				if (MatchFrequency(i)) {
+					nameDistance[channels[i].name] = (int)abs(primDistance - std::distance(names.begin(), names.find(channels[i].name)));
+				}
+			}
+			auto minName = std::min_element(nameDistance.begin(), nameDistance.end(), [](const auto& nd1, const auto& nd2) {
+				return nd1.second < nd2.second;
+				});
+			for (size_t i = 0; minName != nameDistance.end() && i < channels.size(); i++) {
+				if (channels[i].name == minName->first && MatchFrequency(i)) return i;
+			}
+		}
+		else {
+			for (size_t i = 0; i < channels.size(); i++) {
+				if (MatchFrequency(i)) return i;
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+static auto CheckParseAFVStationState(void) -> bool
+{
+	// valid messages with kHz rounding, then malformed ones which must leave state untouched
+	typedef struct _afv_case {
+		const char* message;
+		RDFCommon::afv_parse_error error;
+		int frequency;
+		bool rx;
+		bool tx;
+	} afv_case;
+	constexpr auto none = RDFCommon::afv_parse_error::none;
+	constexpr auto fields = RDFCommon::afv_parse_error::fields;
+	constexpr auto frequency = RDFCommon::afv_parse_error::frequency;
+	constexpr auto boolean = RDFCommon::afv_parse_error::boolean;
+	const afv_case cases[] = {
+		{ "118.700:True:False", none, 118700, true, false },
+		{ "118.7:False:True", none, 118700, false, true },
+		{ "118:True:True", none, 118000, true, true },
+		{ "121.50049:False:False", none, 121500, false, false },
+		{ "121.5005:False:False", none, 121501, false, false },
+		{ "118.9995:True:False", none, 119000, true, false }, // rounding carries into MHz
+		{ "118.9995", fields, 0, false, false },
+		{ ".5", fields, 0, false, false },
+		{ ".5:True:False", frequency, 0, false, false },
+		{ "-118.7", fields, 0, false, false },
+		{ "-118.7:True:False", frequency, 0, false, false },
+		{ "+118.7:True:False", frequency, 0, false, false },
+		{ "121.5 :True:False", frequency, 0, false, false },
+		{ "118.7x:True:False", frequency, 0, false, false },
+		{ "118..7:True:False", frequency, 0, false, false },
+		{ "99999999.000:True:False", frequency, 0, false, false },
+		{ "118.700:true:False", boolean, 0, false, false },
+		{ "118.700:True:", boolean, 0, false, false },
+		{ "118.700:True:False:", fields, 0, false, false },
+		{ "118.700:True", fields, 0, false, false },
+		{ "", fields, 0, false, false }
+	};
+	bool passed = true;
+	for (const auto& c : cases) {
+		RDFCommon::chnl_state state;
+		state.frequency = -1;
+		auto error = RDFCommon::ParseAFVStationState(c.message, state);
+		bool expected = c.error == none ?
+			state.frequency == c.frequency && state.rx == c.rx && state.tx == c.tx : state.frequency == -1;
+		if (error != c.error || !expected) {
+			PLOGE << "self check failed, ParseAFVStationState: \"" << c.message << "\" returned " << RDFCommon::AFVParseErrorName(error)
+				<< " with frequency " << state.frequency;
+			passed = false;
+		}
+	}
+	return passed;
+}
+
+static auto CheckFindChannel(void) -> bool
+{
+	// index lookup must select the same channel as walking the channel list
+	typedef struct _channel_case {
+		const char* name;
+		int frequency;
+		bool isPrim;
+	} channel_case;
+	const std::vector<channel_case> withPrim = {
+		{ "VHHH_APP", 119100, false },
+		{ "VHHH_TWR", 118200, true },
+		{ "VHHH_APP", 120600, false }, // duplicated name
+		{ "VHHH_F_APP", 119100, false },
+		{ "VHHH_DEL", 129900, false },
+		{ "VHHH_GND", 121600, false },
+		{ "VHHK_APP", 119101, false },
+		{ "VHHH_TWR_2", 118400, false },
+		{ "VHHH_GND", 121600, false }, // duplicated name and frequency
+		{ "VHHH_DEL_2", 118400, false }
+	};
+	std::vector<channel_case> withoutPrim = withPrim;
+	withoutPrim[1].isPrim = false;
+	std::vector<channel_case> primDuplicated = withPrim;
+	primDuplicated.push_back({ "VHHH_TWR", 118400, false });
+	auto MakeChannels = [](const std::vector<channel_case>& cases) -> std::vector<RDFCommon::chnl_entry> {
+		std::vector<RDFCommon::chnl_entry> channels;
+		for (const auto& c : cases) {
+			RDFCommon::chnl_state state;
+			state.frequency = c.frequency;
+			state.isPrim = c.isPrim;
+			channels.push_back({ c.name, state, 0 });
+		}
+		return channels;
+		};
+	const std::optional<std::string> callsigns[] = { std::nullopt, "VHHH_APP", "APP", "VHHH_TWR", "HH", "VHHH_F_APP", "VHHH_DEL", "ZZZZ" };
+	const std::optional<int> frequencies[] = { std::nullopt, 119100, 119102, 120600, 118200, 118400, 121600, 129900, 130000 };
+	bool passed = true;
+	for (const auto& cases : { withPrim, withoutPrim, primDuplicated }) {
+		auto channels = MakeChannels(cases);
+		auto index = RDFCommon::BuildChannelIndex(MakeChannels(cases));
+		for (const auto& callsign : callsigns) {
+			for (const auto& frequency : frequencies) {
+				if (RDFCommon::FindChannel(index, callsign, frequency) != SelectChannelReference(channels, callsign, frequency)) {
+					PLOGE << "self check failed, FindChannel: " << callsign.value_or("NULL") << " - " << frequency.value_or(0);
+					passed = false;
+				}
+			}
+		}
+	}
+	// known selections: substring match with frequency when exact name has another one, nearest prim with ties to smaller name
+	auto index = RDFCommon::BuildChannelIndex(MakeChannels(withPrim));
+	auto indexWithoutPrim = RDFCommon::BuildChannelIndex(MakeChannels(withoutPrim));
+	if (RDFCommon::FindChannel(index, "VHHH_DEL", 118400) != 9 ||
+		RDFCommon::FindChannel(index, "VHHH_TWR", 118400) != 7 ||
+		RDFCommon::FindChannel(index, "APP", 120600) != 2 ||
+		RDFCommon::FindChannel(index, std::nullopt, 119100) != 3 ||
+		RDFCommon::FindChannel(indexWithoutPrim, std::nullopt, 119100) != 0 ||
+		RDFCommon::FindChannel(index, "ZZZZ", 121600) != 5) {
+		PLOGE << "self check failed, FindChannel known selections";
+		passed = false;
+	}
+	return passed;
+}
+
+static auto CheckReconcileStationStates(void) -> bool
+{
+	// later stations win, only channels differing from indexed state are returned, prim/atis never
+	auto MakeState = [](const int& frequency, const bool& rx, const bool& tx, const bool& isPrim = false, const bool& isAtis = false) -> RDFCommon::chnl_state {
+		RDFCommon::chnl_state state;
+		state.frequency = frequency;
+		state.rx = rx;
+		state.tx = tx;
+		state.isPrim = isPrim;
+		state.isAtis = isAtis;
+		return state;
+		};
+	std::vector<RDFCommon::chnl_entry> channels = {
+		{ "VHHH_APP", MakeState(119100, false, false), 0 },
+		{ "VHHH_TWR", MakeState(118200, true, true, true), 0 },
+		{ "VHHH_ATIS", MakeState(128200, false, false, false, true), 0 },
+		{ "VHHH_GND", MakeState(121600, true, false), 0 },
+		{ "VHHH_DEL", MakeState(129900, true, true), 0 }
+	};
+	auto index = RDFCommon::BuildChannelIndex(std::move(channels));
+	const std::vector<RDFCommon::station_state> stations = {
+		{ "VHHH_APP", MakeState(119100, true, false) },
+		{ "VHHH_TWR", MakeState(118200, false, false) }, // prim
+		{ "VHHH_ATIS", MakeState(128200, true, false) }, // atis
+		{ "VHHH_GND", MakeState(121600, true, false) }, // unchanged
+		{ "VHHH_DEL", MakeState(129900, false, false) },
+		{ std::nullopt, MakeState(119100, true, true) }, // later station of the same channel
+		{ "ZZZZ", MakeState(130000, true, true) } // not found
+	};
+	auto result = RDFCommon::ReconcileStationStates(index, stations);
+	bool passed = result.size() == 2 &&
+		result[0].first == 0 && result[0].second.rx && result[0].second.tx &&
+		result[1].first == 4 && !result[1].second.rx && !result[1].second.tx;
+	if (!passed) {
+		PLOGE << "self check failed, ReconcileStationStates";
+	}
+	return passed;
+}
+
+static auto CheckStationCoalescer(void) -> bool
+{
+	// latest state per frequency and callsign is applied once, in order of first update
+	using RDFCommon::station_source;
+	auto MakeStation = [](const std::optional<std::string>& callsign, const int& frequency, const bool& rx, const bool& tx) -> RDFCommon::station_state {
+		RDFCommon::station_state station;
+		station.callsign = callsign;
+		station.state.frequency = frequency;
+		station.state.rx = rx;
+		station.state.tx = tx;
+		return station;
+		};
+	RDFCommon::station_coalescer coalescer;
+	bool passed = !coalescer.Due(std::chrono::milliseconds(0));
+	coalescer.Push(station_source::TrackAudio, MakeStation("VHHH_APP", 119100, true, false));
+	coalescer.Push(station_source::AFV, MakeStation(std::nullopt, 118200, true, true));
+	coalescer.Push(station_source::TrackAudio, MakeStation("VHHH_APP", 119100, true, true));
+	coalescer.Push(station_source::TrackAudio, MakeStation("VHHH_APP", 119100, false, false)); // latest wins
+	coalescer.Push(station_source::TrackAudio, MakeStation("VHHH_DEP", 119100, true, false)); // same frequency, other callsign
+	passed = coalescer.Size() == 3 && coalescer.merged == 2 && passed;
+	passed = coalescer.Due(std::chrono::milliseconds(0)) && !coalescer.Due(std::chrono::hours(1)) && passed;
+	auto stations = coalescer.Take();
+	passed = stations.size() == 3 && coalescer.applied == 3 && !coalescer.Size() &&
+		stations[0].callsign == "VHHH_APP" && !stations[0].state.rx && !stations[0].state.tx &&
+		!stations[1].callsign && stations[1].state.frequency == 118200 &&
+		stations[2].callsign == "VHHH_DEP" && passed;
+	if (!passed) {
+		PLOGE << "self check failed, station_coalescer merge";
+	}
+	// full TrackAudio states supersede its own updates only, discarded ones are not merged
+	coalescer.Push(station_source::TrackAudio, MakeStation("VHHH_APP", 119100, true, false));
+	coalescer.Push(station_source::AFV, MakeStation(std::nullopt, 118200, false, false));
+	coalescer.Push(station_source::TrackAudio, MakeStation("VHHH_GND", 121600, true, false));
+	coalescer.Clear(station_source::TrackAudio);
+	passed = coalescer.Size() == 1 && coalescer.merged == 2 && coalescer.Due(std::chrono::milliseconds(0)) && passed;
+	stations = coalescer.Take();
+	passed = stations.size() == 1 && !stations[0].callsign && !stations[0].state.rx && coalescer.applied == 4 && passed;
+	coalescer.Clear(station_source::AFV);
+	passed = !coalescer.Size() && !coalescer.Due(std::chrono::milliseconds(0)) && passed;
+	if (!passed) {
+		PLOGE << "self check failed, station_coalescer clear";
+	}
+	return passed;
+}
+
+static auto CheckReplayLog(void) -> bool
+{
+	// records read back in order with payloads intact, a truncated tail keeps the complete records
+	const std::vector<std::pair<RDFCommon::replay_source, std::string>> written = {
+		{ RDFCommon::replay_source::TrackAudio, R"({"type":"kRxBegin","value":{"callsign":"CPA123","pFrequencyHz":118700000}})" },
+		{ RDFCommon::replay_source::AFVTransmission, "CPA123:VHHH_APP:" },
+		{ RDFCommon::replay_source::AFVTransmission, "" },
+		{ RDFCommon::replay_source::AFVStationState, std::string("119.100:True:False\0\xFF", 20) }
+	};
+	auto path = std::filesystem::temp_directory_path() / (std::string("RDFSelfCheck") + REPLAY_FILE_EXTENSION);
+	RDFCommon::replay_recorder recorder;
+	bool passed = recorder.Start(path) && !recorder.Start(path);
+	for (const auto& [source, payload] : written) {
+		recorder.Write(source, payload);
+	}
+	passed = recorder.Stop() == written.size() && passed;
+	recorder.Write(RDFCommon::replay_source::TrackAudio, "not recorded");
+	std::vector<RDFCommon::replay_record> records;
+	passed = RDFCommon::ReadReplayLog(path, records) && records.size() == written.size() && passed;
+	for (size_t i = 0; passed && i < records.size(); i++) {
+		passed = records[i].source == written[i].first && records[i].payload == written[i].second &&
+			(!i || records[i].timestamp >= records[i - 1].timestamp);
+	}
+	std::error_code ec;
+	std::filesystem::resize_file(path, std::filesystem::file_size(path, ec) - 3, ec);
+	passed = !ec && RDFCommon::ReadReplayLog(path, records) && records.size() == written.size() - 1 && passed;
+	std::filesystem::resize_file(path, 4, ec);
+	passed = !ec && !RDFCommon::ReadReplayLog(path, records) && passed;
+	std::filesystem::remove(path, ec);
+	if (!passed) {
+		PLOGE << "self check failed, replay log round trip";
+	}
+	return passed;
+}
+
+static auto CheckRandomGenerator(void) -> bool
+{
+	// same seed gives same sequence on every thread, offsets follow bearing uniform and distance |N(0,1)|/3
+	auto Sequence = [](RDFCommon::random_generator& generator) -> std::vector<uint64_t> {
+		std::vector<uint64_t> values(16);
+		for (auto& v : values) {
+			v = generator.Next();
+		}
+		return values;
+		};
+	RDFCommon::random_generator seeded(42), again(42), other(43);
+	auto expected = Sequence(seeded);
+	bool passed = expected == Sequence(again) && expected != Sequence(other);
+	RDFCommon::SetRandomSeed(42);
+	passed = Sequence(RDFCommon::GetRandomGenerator()) == expected && passed;
+	RDFCommon::SetRandomSeed(42); // restarts sequence
+	passed = Sequence(RDFCommon::GetRandomGenerator()) == expected && passed;
+	std::vector<uint64_t> threaded;
+	std::thread([&](void) { threaded = Sequence(RDFCommon::GetRandomGenerator()); }).join();
+	passed = threaded == expected && passed;
+	RDFCommon::SetRandomSeed(std::nullopt);
+	auto first = Sequence(RDFCommon::GetRandomGenerator());
+	std::thread([&](void) { threaded = Sequence(RDFCommon::GetRandomGenerator()); }).join();
+	passed = first != expected && threaded != first && passed;
+	// batch statistics, mean of |N(0,1)|/3 is sqrt(2/pi)/3
+	std::vector<RDFCommon::draw_offset> offsets(100001);
+	seeded.Offsets(offsets);
+	double sumBearing = 0, sumDistance = 0;
+	for (const auto& offset : offsets) {
+		passed = offset.bearing >= 0 && offset.bearing < 360 && offset.distance >= 0 && passed;
+		sumBearing += offset.bearing;
+		sumDistance += offset.distance;
+	}
+	passed = fabs(sumBearing / offsets.size() - 180.0) < 2.0 && fabs(sumDistance / offsets.size() - sqrt(2.0 / pi) / 3.0) < 0.005 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, random generator";
+	}
+	return passed;
+}
+
+static auto CheckAddOffsets(void) -> bool
+{
+	// batch kernel against AddOffset for every origin and offset, SIMD lanes and scalar tail alike
+	const std::vector<RDFCommon::geo_position> origins = {
+		{ 22.3, 113.9 }, { 0.0, 0.0 }, { -33.9, 151.2 }, { 51.5, -0.5 }, { 64.1, -179.9 }, { -89.5, 45.0 }, { 89.9, -120.0 }
+	};
+	std::vector<RDFCommon::draw_offset> offsets = {
+		{ 0, 20 }, { 90, 20 }, { 180, 20 }, { 270, 20 }, { 45, 0 }, { 10, 0.0000001 }, { -30, 1 }, { 725, 2 }, { 123.4, 3000 }, { 300, 6000 }
+	};
+	RDFCommon::random_generator random(11);
+	for (size_t i = 0; i < 37; i++) { // odd count leaves a tail for every lane width
+		offsets.push_back({ random.Uniform() * 360.0, random.Uniform() * 100.0 });
+	}
+	std::vector<RDFCommon::geo_position> positions(origins.size() * offsets.size() + 1, { 1000.0, 1000.0 });
+	RDFCommon::AddOffsets(origins, offsets, { positions.data(), positions.size() - 3 }); // last origin doesn't fit
+	auto AngleError = [](const double& a, const double& b) -> double {
+		double d = fmod(fabs(a - b), 360.0);
+		return (std::min)(d, 360.0 - d);
+		};
+	bool passed = positions[positions.size() - 1].latitude == 1000.0 && positions[positions.size() - offsets.size() - 1].latitude == 1000.0;
+	for (size_t o = 0; o + 1 < origins.size(); o++) {
+		for (size_t i = 0; i < offsets.size(); i++) {
+			auto reference = origins[o];
+			RDFCommon::AddOffset(reference, offsets[i].bearing, offsets[i].distance);
+			const auto& position = positions[o * offsets.size() + i];
+			if (fabs(position.latitude - reference.latitude) > 1e-9 || AngleError(position.longitude, reference.longitude) > 1e-9) {
+				PLOGE << "self check failed, AddOffsets: " << origins[o].latitude << " " << origins[o].longitude << " - " << offsets[i].bearing << " " << offsets[i].distance;
+				passed = false;
+			}
+		}
+	}
+	return passed;
+}
+
+static auto CheckAddRing(void) -> bool
+{
+	// every ring vertex at every LOD must match AddOffset at the same bearing, and LOD must bound chord error
+	const RDFCommon::geo_position origins[] = { { 0.0, 0.0 }, { 22.3, 113.9 }, { -33.9, 151.2 }, { 64.1, -21.9 }, { 89.5, -45.0 }, { -60.0, 179.9 } };
+	const double distances[] = { 0.0, 0.5, 20.0, 250.0, 3000.0 }; // nm
+	bool passed = true;
+	std::vector<RDFCommon::geo_position> ring;
+	for (size_t level = 0; level < RING_LOD_LEVELS; level++) {
+		const auto& lod = RDFCommon::GetRingLod(level);
+		for (const auto& origin : origins) {
+			for (const auto& distance : distances) {
+				RDFCommon::AddRing(origin, distance, lod, ring);
+				for (size_t i = 0; i < ring.size(); i++) {
+					auto expected = origin;
+					RDFCommon::AddOffset(expected, 360.0 * (double)i / (double)ring.size(), distance);
+					if (fabs(ring[i].latitude - expected.latitude) > 1e-9 || fabs(ring[i].longitude - expected.longitude) > 1e-9) {
+						PLOGE << "self check failed, AddRing: " << origin.latitude << " " << origin.longitude << " - " << distance << " vertex " << i << "/" << ring.size();
+						passed = false;
+						break;
+					}
+				}
+			}
+		}
+	}
+	for (const double pixelRadius : { 0.0, 5.0, 25.0, 100.0, 400.0, 1000.0 }) {
+		size_t level = RDFCommon::RingLodLevel(pixelRadius);
+		double vertices = (double)RDFCommon::GetRingLod(level).sinBearing.size();
+		if (level >= RING_LOD_LEVELS || (level + 1 < RING_LOD_LEVELS && pixelRadius * pi * pi / (2.0 * vertices * vertices) > 0.5)) {
+			PLOGE << "self check failed, RingLodLevel: " << pixelRadius;
+			passed = false;
+		}
+	}
+	return passed;
+}
+
+static auto CheckLatencyHistogram(void) -> bool
+{
+	// percentiles within bucket error, exact below 32us, values past range clamped into last bucket
+	bool passed = true;
+	auto Near = [](const double& value, const double& expected, const double& error) -> bool {
+		return fabs(value - expected) <= expected * error;
+		};
+	RDFCommon::latency_histogram histogram;
+	for (int i = 1; i <= 1000; i++) {
+		histogram.Record(std::chrono::milliseconds(i));
+	}
+	if (histogram.Count() != 1000 || !Near(histogram.Percentile(0.5), 500.0, 0.035) || !Near(histogram.Percentile(0.99), 990.0, 0.035) || histogram.Max() != 1000.0) {
+		PLOGE << "self check failed, latency_histogram: " << histogram.Percentile(0.5) << " " << histogram.Percentile(0.99) << " " << histogram.Max();
+		passed = false;
+	}
+	histogram.Reset();
+	for (int i = 0; i < 32; i++) {
+		histogram.Record(std::chrono::microseconds(i));
+	}
+	histogram.Record(std::chrono::hours(24 * 365));
+	histogram.Record(std::chrono::microseconds(-5)); // clock skew
+	if (histogram.Count() != 34 || histogram.Percentile(0.5) != 0.015 || histogram.Max() != (double)((1ull << 36) - 1) / 1000.0 || histogram.Percentile(1.0) != histogram.Max()) {
+		PLOGE << "self check failed, latency_histogram range: " << histogram.Percentile(0.5) << " " << histogram.Max();
+		passed = false;
+	}
+	histogram.Reset();
+	if (histogram.Count() || histogram.Percentile(0.5) != 0.0 || histogram.Max() != 0.0) {
+		PLOGE << "self check failed, latency_histogram reset";
+		passed = false;
+	}
+	return passed;
+}
+
+static auto CheckBoundedQueue(void) -> bool
+{
+	// push drops the new item when full, push_evict drops the oldest, every item is either popped or counted
+	bool passed = true;
+	RDFCommon::bounded_queue<int, 4> queue;
+	for (int i = 1; i <= 4; i++) {
+		passed = queue.push(std::move(i)) && passed;
+	}
+	passed = !queue.push(5) && queue.drops() == 1 && passed;
+	passed = !queue.push_evict(6) && queue.drops() == 2 && passed;
+	std::vector<int> items;
+	for (int item; queue.pop(item);) {
+		items.push_back(item);
+	}
+	passed = items == std::vector<int>{ 2, 3, 4, 6 } && passed;
+	if (!passed) {
+		PLOGE << "self check failed, bounded_queue order";
+	}
+	constexpr size_t PUSHES = 20000;
+	RDFCommon::bounded_queue<size_t, 64> queueShared;
+	std::atomic<size_t> producing = 2;
+	size_t popped = 0;
+	auto Producer = [&](void) {
+		for (size_t i = 0; i < PUSHES; i++) {
+			queueShared.push_evict(std::move(i));
+		}
+		producing--;
+		};
+	std::thread producerA(Producer), producerB(Producer);
+	for (size_t item; producing || queueShared.size();) {
+		if (queueShared.pop(item)) {
+			popped++;
+		}
+	}
+	producerA.join();
+	producerB.join();
+	if (popped + queueShared.drops() != 2 * PUSHES) {
+		PLOGE << "self check failed, bounded_queue push_evict: " << popped << " popped, " << queueShared.drops() << " dropped";
+		passed = false;
+	}
+	return passed;
+}
+
+static auto CheckTrace(void) -> bool
+{
+	// spans of every thread are exported as nested Chrome trace events, nothing is recorded while stopped
+	auto path = std::filesystem::temp_directory_path() / (std::string("RDFSelfCheck") + TRACE_FILE_EXTENSION);
+	bool passed = RDFCommon::TraceStop(path) == 0 && RDFCommon::TraceStart() && !RDFCommon::TraceStart();
+	{
+		RDFCommon::trace_scope outer("check outer");
+		RDFCommon::trace_scope inner("check inner");
+	}
+	std::thread([](void) {
+		RDFCommon::TraceThreadName("SelfCheck worker");
+		RDFCommon::trace_scope worker("check worker");
+		}).join();
+	passed = RDFCommon::TraceStop(path) == 3 && passed;
+	{
+		RDFCommon::trace_scope stopped("check stopped");
+	}
+	try {
+		std::map<std::string, nlohmann::json> spans;
+		std::string workerName;
+		std::ifstream file(path);
+		auto trace = nlohmann::json::parse(file);
+		for (const auto& e : trace.at("traceEvents")) {
+			if (e.at("ph") == "X") {
+				spans[e.at("name").get<std::string>()] = e;
+			}
+			else if (e.at("ph") == "M") {
+				workerName = e.at("args").at("name").get<std::string>();
+			}
+		}
+		const auto& outer = spans.at("check outer");
+		const auto& inner = spans.at("check inner");
+		const auto& worker = spans.at("check worker");
+		passed = spans.size() == 3 && workerName == "SelfCheck worker" && passed;
+		passed = outer.at("tid") == inner.at("tid") && outer.at("tid") != worker.at("tid") && passed;
+		// both are truncated to microseconds, inner may end 1us late
+		passed = inner.at("ts") >= outer.at("ts") && inner.at("ts").get<int64_t>() + inner.at("dur").get<int64_t>() <= outer.at("ts").get<int64_t>() + outer.at("dur").get<int64_t>() + 1 && passed;
+	}
+	catch (std::exception const& e) {
+		PLOGE << "Error: " << e.what();
+		passed = false;
+	}
+	std::error_code ec;
+	std::filesystem::remove(path, ec);
+	if (!passed) {
+		PLOGE << "self check failed, trace";
+	}
+	return passed;
+}
+
+static auto CheckCallsignPositions(void) -> bool
+{
+	// IDs are stable and looked up without interning, flat records behave as a map ordered by ID
+	bool passed = true;
+	RDFCommon::callsign_table table;
+	auto cpa = table.Intern("CPA123");
+	auto ces = table.Intern("CES456");
+	passed = cpa != ces && table.Intern(std::string("CPA123")) == cpa && table.Name(ces) == "CES456" && passed;
+	passed = table.Find("CES456") == ces && !table.Find("UAL789") && table.Size() == 2 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, callsign_table";
+	}
+	RDFCommon::random_generator random(7);
+	RDFCommon::callsign_position positions;
+	std::map<RDFCommon::callsign_id, double> reference;
+	for (size_t i = 0; i < 2000; i++) {
+		auto id = (RDFCommon::callsign_id)(random.Uniform() * 64.0);
+		if (random.Uniform() < 0.5) {
+			passed = RDFCommon::ErasePosition(positions, id) == (bool)reference.erase(id) && passed;
+		}
+		else {
+			RDFCommon::InsertPosition(positions, id, RDFCommon::draw_position({ 0.0, 0.0 }, (double)i));
+			reference[id] = (double)i;
+		}
+	}
+	passed = positions.size() == reference.size() && passed;
+	auto it = reference.begin();
+	for (size_t i = 0; passed && i < positions.size(); i++, it++) {
+		const auto* found = RDFCommon::FindPosition(positions, it->first);
+		passed = positions[i].first == it->first && positions[i].second.radius == it->second && found == &positions[i].second;
+	}
+	if (!passed) {
+		PLOGE << "self check failed, callsign_position";
+	}
+	return passed;
+}
+
+static auto CheckCallsignSet(void) -> bool
+{
+	// every publish is a new generation, stale slots never match and readers never see a partial publish
+	bool passed = true;
+	RDFCommon::callsign_set set;
+	auto generation = set.Generation();
+	passed = !set.Contains("CPA123") && !set.Contains("") && passed;
+	set.Publish({ "CPA123", "CES456", "CPA123" });
+	passed = set.Contains("CPA123") && set.Contains("CES456") && !set.Contains("UAL789") && passed;
+	passed = set.Generation() == generation + 2 && passed;
+	set.Publish({ "UAL789" });
+	passed = !set.Contains("CPA123") && !set.Contains("CES456") && set.Contains("UAL789") && passed;
+	set.Publish({});
+	passed = !set.Contains("UAL789") && set.Generation() == generation + 6 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, callsign_set generations";
+	}
+	// random subsets against reference
+	std::vector<std::string> names;
+	for (size_t i = 0; i < 64; i++) {
+		names.push_back("SIM" + std::to_string(i));
+	}
+	RDFCommon::random_generator random(19);
+	for (size_t round = 0; passed && round < 500; round++) {
+		std::vector<std::string_view> published;
+		std::set<std::string_view> reference;
+		for (const auto& name : names) {
+			if (random.Uniform() < 0.3) {
+				published.push_back(name);
+				reference.insert(name);
+			}
+		}
+		set.Publish(published);
+		for (const auto& name : names) {
+			passed = set.Contains(name) == reference.contains(name) && passed;
+		}
+	}
+	if (!passed) {
+		PLOGE << "self check failed, callsign_set subsets";
+	}
+	// a callsign kept across publishes stays visible to a concurrent reader
+	std::atomic<bool> publishing = true;
+	std::atomic<size_t> misses = 0;
+	std::thread reader([&](void) {
+		while (publishing) {
+			if (!set.Contains("CPA123")) misses++;
+		}
+		});
+	for (size_t round = 0; round < 20000; round++) {
+		if (round & 1) set.Publish({ "CPA123", "CES456" });
+		else set.Publish({ "UAL789", "CPA123" });
+	}
+	publishing = false;
+	reader.join();
+	if (misses) {
+		PLOGE << "self check failed, callsign_set concurrent reader, misses: " << misses;
+		passed = false;
+	}
+	return passed;
+}
+
+// Silences expected errors logged by code under check, restores severity when out of scope
+typedef struct _quiet_log {
+	plog::Severity severity = plog::get() != nullptr ? plog::get()->getMaxSeverity() : plog::none;
+	_quiet_log(void) { if (plog::get() != nullptr) plog::get()->setMaxSeverity(plog::none); }
+	~_quiet_log(void) { if (plog::get() != nullptr) plog::get()->setMaxSeverity(severity); }
+} quiet_log;
+
+// Host with fixed radar targets, controllers and channels, position in channels is handle
+class check_host : public RDFCommon::plugin_host {
+public:
+	std::map<std::string, RDFCommon::target_data> targets;
+	std::map<std::string, RDFCommon::geo_position> controllers;
+	std::vector<RDFCommon::chnl_entry> channels;
+	size_t selectRadarTarget = 0;
+	size_t selectController = 0;
+	size_t enumerateChannels = 0;
+	size_t channelReads = 0;
+	size_t toggles = 0;
+
+	auto SelectRadarTarget(const std::string& callsign) -> std::optional<RDFCommon::target_data> override
+	{
+		selectRadarTarget++;
+		auto it = targets.find(callsign);
+		return it != targets.end() ? std::optional(it->second) : std::nullopt;
+	}
+	auto SelectController(const std::string& callsign) -> std::optional<RDFCommon::geo_position> override
+	{
+		selectController++;
+		auto it = controllers.find(callsign);
+		return it != controllers.end() ? std::optional(it->second) : std::nullopt;
+	}
+	auto EnumerateChannels(std::vector<RDFCommon::chnl_entry>& entries) -> void override
+	{
+		enumerateChannels++;
+		entries = channels;
+	}
+	auto GetChannelSignature(void) -> RDFCommon::chnl_signature override { return RDFCommon::ChannelSignature(channels); }
+	auto IsChannel(const size_t& handle, const std::string& name) -> bool override { return handle < channels.size() && channels[handle].name == name; }
+	auto GetChannelState(const size_t& handle) -> std::optional<RDFCommon::chnl_state> override
+	{
+		if (handle >= channels.size()) return std::nullopt;
+		channelReads++;
+		return channels[handle].state;
+	}
+	auto ToggleTextReceive(const size_t& handle) -> void override
+	{
+		toggles++;
+		channels[handle].state.rx = !channels[handle].state.rx;
+	}
+	auto ToggleTextTransmit(const size_t& handle) -> void override
+	{
+		toggles++;
+		channels[handle].state.tx = !channels[handle].state.tx;
+	}
+	auto GetSetting(const std::string&) -> std::optional<std::string> override { return std::nullopt; }
+	auto SaveSetting(const std::string&, const std::string&, const std::string&) -> void override {}
+	auto DisplayMessage(const RDFCommon::message_level&, const std::string&) -> void override {}
+	auto IsDirectConnection(void) -> bool override { return true; }
+};
+
+static auto PostTransmission(RDFCommon::plugin_engine& engine, const std::string& callsign, const bool& rxEnd) -> bool
+{
+	RDFCommon::plugin_event event;
+	event.type = rxEnd ? RDFCommon::event_type::TrackAudioRxEnd : RDFCommon::event_type::TrackAudioRxBegin;
+	event.message = callsign;
+	engine.PostEvent(std::move(event));
+	return engine.ProcessEvents(nullptr);
+}
+
+static auto CheckFollowTarget(void) -> bool
+{
+	// records keep their offset and move with their radar target, published once by next ProcessEvents
+	bool passed = true;
+	check_host host;
+	host.targets["CPA123"] = { { 22.3, 113.9 }, 20000 };
+	host.targets["CES456"] = { { 23.0, 114.5 }, 35000 };
+	host.controllers["CES456B"] = { 22.0, 113.0 }; // pilot transmitting on controller callsign
+	host.controllers["VHHK_APP"] = { 22.3, 114.2 };
+	RDFCommon::plugin_engine engine(host);
+	auto settings = std::make_shared<RDFCommon::position_settings>();
+	settings->circleThreshold = 0;
+	settings->lowPrecision = 2;
+	settings->highPrecision = 10;
+	settings->highAltitude = 30000;
+	settings->drawController = true;
+	engine.SetPositionSettings(settings);
+	passed = PostTransmission(engine, "CPA123", false) && PostTransmission(engine, "CES456B", false) && PostTransmission(engine, "VHHK_APP", false) && passed;
+	auto before = engine.GetSnapshot();
+	passed = before->current.size() == 3 && passed;
+	auto selects = host.selectRadarTarget;
+
+	// not followed, nothing to publish
+	engine.OnRadarTargetPositionUpdate("UAL789", { { 0.0, 0.0 }, 10000 });
+	engine.OnRadarTargetPositionUpdate("VHHK_APP", { { 0.0, 0.0 }, 0 });
+	passed = !engine.ProcessEvents(nullptr) && engine.GetSnapshot() == before && passed;
+
+	// moved by target, offset kept, published once
+	RDFCommon::geo_position moved = { 22.5, 114.0 };
+	engine.OnRadarTargetPositionUpdate("CPA123", { moved, 21000 });
+	engine.OnRadarTargetPositionUpdate("CES456", { moved, 36000 });
+	passed = engine.GetSnapshot() == before && passed;
+	passed = engine.ProcessEvents(nullptr) && engine.GetSnapshot()->version == before->version + 1 && passed;
+	auto after = engine.GetSnapshot();
+	for (const auto& [callsign, dp] : before->current) {
+		const auto* found = RDFCommon::FindPosition(after->current, callsign);
+		if (found == nullptr || found->radius != dp.radius) {
+			passed = false;
+			continue;
+		}
+		auto expected = dp.target ? moved : dp.position;
+		if (dp.target) {
+			RDFCommon::AddOffset(expected, dp.offset.bearing, dp.offset.distance);
+		}
+		passed = std::abs(found->position.latitude - expected.latitude) < 1e-9 && std::abs(found->position.longitude - expected.longitude) < 1e-9 && passed;
+	}
+	passed = std::count_if(after->current.begin(), after->current.end(), [](const auto& item) { return item.second.target.has_value(); }) == 2 && passed;
+	passed = after->previous.size() == 3 && host.selectRadarTarget == selects && passed;
+
+	// ended transmissions are no longer followed
+	passed = PostTransmission(engine, "CPA123", true) && PostTransmission(engine, "CES456B", true) && passed;
+	before = engine.GetSnapshot();
+	engine.OnRadarTargetPositionUpdate("CPA123", { { 0.0, 0.0 }, 21000 });
+	engine.OnRadarTargetPositionUpdate("CES456", { { 0.0, 0.0 }, 21000 });
+	passed = !engine.ProcessEvents(nullptr) && engine.GetSnapshot() == before && passed;
+	if (!passed) {
+		PLOGE << "self check failed, follow target";
+	}
+	return passed;
+}
+
+static auto CheckCallsignCache(void) -> bool
+{
+	// host API only for unseen or stale callsigns, absent controllers stay absent until reported, stale data is pruned
+	bool passed = true;
+	check_host host;
+	host.targets["CPA123"] = { { 22.3, 113.9 }, 20000 };
+	host.targets["CES456"] = { { 23.0, 114.5 }, 35000 };
+	host.controllers["VHHK_APP"] = { 22.3, 114.2 };
+	RDFCommon::plugin_engine engine(host);
+	auto settings = std::make_shared<RDFCommon::position_settings>();
+	settings->drawController = true;
+	engine.SetPositionSettings(settings);
+
+	// reported by callbacks, only the controller of an unseen pilot is selected once
+	engine.OnRadarTargetPositionUpdate("CPA123", host.targets["CPA123"]);
+	engine.OnControllerPositionUpdate("VHHK_APP", host.controllers["VHHK_APP"]);
+	passed = PostTransmission(engine, "CPA123", false) && host.selectRadarTarget == 0 && host.selectController == 1 && passed;
+	passed = PostTransmission(engine, "CPA123", true) && PostTransmission(engine, "CPA123", false) && host.selectController == 1 && passed;
+	passed = PostTransmission(engine, "VHHK_APP", false) && engine.GetSnapshot()->current.size() == 2 && passed;
+	auto selects = host.selectRadarTarget + host.selectController; // radar target of controller and its fallback
+	passed = PostTransmission(engine, "VHHK_APP", true) && PostTransmission(engine, "VHHK_APP", false) && host.selectRadarTarget + host.selectController == selects && passed;
+	if (!passed) {
+		PLOGE << "self check failed, callsign cache lookups";
+	}
+
+	// disconnected controller is absent without selecting, until it reports again
+	passed = PostTransmission(engine, "VHHK_APP", true) && passed;
+	engine.OnControllerDisconnect("VHHK_APP");
+	passed = !PostTransmission(engine, "VHHK_APP", false) && passed;
+	engine.OnControllerPositionUpdate("VHHK_APP", host.controllers["VHHK_APP"]);
+	passed = PostTransmission(engine, "VHHK_APP", false) && passed;
+	// flight plan disconnect marks the target absent
+	passed = PostTransmission(engine, "CPA123", true) && passed;
+	engine.OnFlightPlanDisconnect("CPA123");
+	passed = !PostTransmission(engine, "CPA123", false) && host.selectRadarTarget + host.selectController == selects && passed;
+	if (!passed) {
+		PLOGE << "self check failed, callsign cache disconnects";
+	}
+
+	// pilot on a controller callsign, fallback interned once and followed
+	host.controllers["CES456B"] = { 22.0, 113.0 };
+	engine.OnControllerPositionUpdate("CES456B", host.controllers["CES456B"]);
+	engine.OnRadarTargetPositionUpdate("CES456", host.targets["CES456"]);
+	passed = PostTransmission(engine, "CES456B", false) && passed;
+	auto snapshot = engine.GetSnapshot();
+	passed = snapshot->current.size() == 2 && std::count_if(snapshot->current.begin(), snapshot->current.end(), [](const auto& item) { return item.second.target.has_value(); }) == 1 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, callsign cache fallback";
+	}
+
+	// stale data is dropped and unused callsigns released, records and their targets are kept
+	size_t interned = engine.CallsignsInterned();
+	engine.OnRadarTargetPositionUpdate("UAL789", { { 21.0, 113.0 }, 10000 });
+	passed = engine.CallsignsInterned() == interned + 1 && passed;
+	engine.PruneCallsigns(std::chrono::steady_clock::now());
+	passed = engine.CallsignsInterned() == interned + 1 && passed;
+	engine.PruneCallsigns(std::chrono::steady_clock::now() + std::chrono::seconds(CALLSIGN_DATA_TIMEOUT_SEC + 1));
+	passed = engine.CallsignsInterned() == 3 && passed; // VHHK_APP, CES456B and its target CES456 of records
+	engine.OnRadarTargetPositionUpdate("CES456", { { 23.1, 114.6 }, 35000 });
+	passed = engine.ProcessEvents(nullptr) && engine.GetSnapshot()->current.size() == 2 && passed;
+	// released IDs are reused without touching records
+	engine.OnRadarTargetPositionUpdate("UAL789", { { 21.0, 113.0 }, 10000 });
+	engine.OnRadarTargetPositionUpdate("CPA123", host.targets["CPA123"]);
+	passed = PostTransmission(engine, "UAL789", false) && PostTransmission(engine, "CPA123", false) && engine.GetSnapshot()->current.size() == 4 && passed;
+	passed = PostTransmission(engine, "CES456B", true) && engine.GetSnapshot()->current.size() == 3 && engine.IsPreviousTransmitter("UAL789") && passed;
+	engine.ClearTransmission();
+	engine.PruneCallsigns(std::chrono::steady_clock::now() + std::chrono::seconds(CALLSIGN_DATA_TIMEOUT_SEC + 1));
+	passed = engine.CallsignsInterned() == 0 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, callsign cache pruning";
+	}
+	return passed;
+}
+
+static auto PostAFVTransmission(RDFCommon::plugin_engine& engine, const std::string& message) -> bool
+{
+	RDFCommon::plugin_event event;
+	event.type = RDFCommon::event_type::AFVTransmission;
+	event.message = message;
+	engine.PostEvent(std::move(event));
+	return engine.ProcessEvents(nullptr);
+}
+
+static auto CheckAFVTransmission(void) -> bool
+{
+	// records follow the last AFV list like a rebuild would, only differences are drawn
+	bool passed = true;
+	check_host host;
+	host.targets["CPA123"] = { { 22.3, 113.9 }, 20000 };
+	host.targets["CES456"] = { { 23.0, 114.5 }, 35000 };
+	host.targets["UAL789"] = { { 21.0, 113.0 }, 10000 };
+	RDFCommon::plugin_engine engine(host);
+	auto Transmitters = [&engine](void) -> size_t { return engine.GetSnapshot()->current.size(); };
+	passed = PostAFVTransmission(engine, "CPA123:CES456:") && Transmitters() == 2 && passed;
+	auto first = engine.GetSnapshot()->current;
+	// resend without change, existing records are not drawn again
+	passed = !PostAFVTransmission(engine, "CES456::CPA123:CES456") && passed;
+	// records from TrackAudio are cleared by AFV as before
+	passed = PostTransmission(engine, "UAL789", false) && Transmitters() == 3 && passed;
+	passed = PostAFVTransmission(engine, "CPA123:CES456") && Transmitters() == 2 && !engine.IsPreviousTransmitter("UAL789") && passed;
+	// removed
+	passed = PostAFVTransmission(engine, "CES456") && Transmitters() == 1 && passed;
+	auto kept = RDFCommon::FindPosition(engine.GetSnapshot()->current, first.back().first);
+	passed = kept != nullptr && kept->position.latitude == first.back().second.position.latitude && kept->position.longitude == first.back().second.position.longitude && passed;
+	if (!passed) {
+		PLOGE << "self check failed, AFV transmission add and remove";
+	}
+	// failed to draw, retried on resend once the target is known
+	passed = !PostAFVTransmission(engine, "CES456:SIA321") && Transmitters() == 1 && passed;
+	auto selects = host.selectRadarTarget;
+	passed = !PostAFVTransmission(engine, "CES456:SIA321") && host.selectRadarTarget == selects && passed; // absent cached
+	engine.OnRadarTargetPositionUpdate("SIA321", { { 22.0, 114.0 }, 30000 });
+	passed = PostAFVTransmission(engine, "CES456:SIA321") && Transmitters() == 2 && engine.IsPreviousTransmitter("SIA321") && passed;
+	// empty list clears records and keeps previous
+	passed = PostAFVTransmission(engine, "") && Transmitters() == 0 && engine.GetSnapshot()->previous.size() == 2 && passed;
+	passed = !PostAFVTransmission(engine, "") && passed;
+	if (!passed) {
+		PLOGE << "self check failed, AFV transmission retry";
+	}
+	return passed;
+}
+
+static auto CheckChannelMirror(void) -> bool
+{
+	// toggles are decided on mirror, host is read only around real toggles or when channel list is changed
+	auto MakeEntry = [](const std::string& name, const int& frequency, const bool& isPrim = false, const bool& isAtis = false) -> RDFCommon::chnl_entry {
+		RDFCommon::chnl_entry entry;
+		entry.name = name;
+		entry.state.frequency = frequency;
+		entry.state.isPrim = isPrim;
+		entry.state.isAtis = isAtis;
+		return entry;
+		};
+	auto MakeState = [](const int& frequency, const bool& rx, const bool& tx) -> RDFCommon::chnl_state {
+		RDFCommon::chnl_state state;
+		state.frequency = frequency;
+		state.rx = rx;
+		state.tx = tx;
+		return state;
+		};
+	check_host host;
+	host.channels = {
+		MakeEntry("VHHH_TWR", 118200, true),
+		MakeEntry("VHHH_APP", 119100),
+		MakeEntry("VHHH_ATIS", 128200, false, true),
+		MakeEntry("VHHH_GND", 121600)
+	};
+	RDFCommon::plugin_engine engine(host);
+	engine.IndexGroundToAirChannels(true);
+	engine.IndexGroundToAirChannels(false);
+	bool passed = host.enumerateChannels == 1;
+	engine.UpdateChannel("VHHH_APP", MakeState(119100, true, true));
+	passed = host.channels[1].state.rx && host.channels[1].state.tx && host.toggles == 2 && host.channelReads == 2 && passed;
+	// unchanged, prim and atis are decided without host
+	engine.UpdateChannel("VHHH_APP", MakeState(119100, true, true));
+	engine.UpdateChannel("VHHH_TWR", MakeState(118200, false, true));
+	engine.UpdateChannel(std::nullopt, MakeState(128200, true, false));
+	passed = host.toggles == 2 && host.channelReads == 2 && passed;
+	// changed by user since mirrored, live state is read before toggling
+	host.channels[1].state.tx = false;
+	engine.UpdateChannel("VHHH_APP", MakeState(119100, false, false));
+	passed = !host.channels[1].state.rx && !host.channels[1].state.tx && host.toggles == 3 && host.channelReads == 4 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, channel mirror toggles";
+	}
+	// deactivating all enumerates once and toggles only active channels
+	host.channels[3].state.rx = true; // by user
+	host.channels[0].state.rx = true;
+	engine.UpdateChannel(std::nullopt, std::nullopt);
+	passed = !host.channels[3].state.rx && host.channels[0].state.rx && host.toggles == 4 && host.enumerateChannels == 2 && passed;
+	// changed list is enumerated and reindexed by next check
+	host.channels.push_back(MakeEntry("VHHH_DEL", 129900));
+	engine.IndexGroundToAirChannels(false);
+	engine.IndexGroundToAirChannels(false);
+	engine.UpdateChannel("VHHH_DEL", MakeState(129900, true, false));
+	passed = host.enumerateChannels == 3 && host.channels[4].state.rx && passed;
+	host.channels.back().name = "VHHH_CLR";
+	engine.IndexGroundToAirChannels(false);
+	passed = host.enumerateChannels == 4 && passed;
+	if (!passed) {
+		PLOGE << "self check failed, channel mirror revalidation";
+	}
+	return passed;
+}
+
+static auto Mutate(const std::string& input, RDFCommon::random_generator& random) -> std::string
+{
+	// a few byte edits, truncations or repeated slices, biased towards separators and literals
+	constexpr std::string_view alphabet = ":.,{}[]\"\\ -+e0123456789TrueFalsekRx\t\n\x80\xC3";
+	auto Pick = [&random](const size_t& size) -> size_t { return (size_t)(random.Uniform() * (double)size); };
+	std::string output = input;
+	for (size_t edits = 1 + Pick(4); edits; edits--) {
+		double r = random.Uniform();
+		size_t pos = Pick(output.size() + 1);
+		if (r < 0.25 && pos < output.size()) {
+			output[pos] = alphabet[Pick(alphabet.size())];
+		}
+		else if (r < 0.45) {
+			output.insert(pos, 1, alphabet[Pick(alphabet.size())]);
+		}
+		else if (r < 0.65 && pos < output.size()) {
+			output.erase(pos, 1 + Pick(3));
+		}
+		else if (r < 0.75) {
+			output.resize(pos);
+		}
+		else if (r < 0.9 && pos < output.size()) {
+			output[pos] ^= (char)(1 << Pick(8));
+		}
+		else {
+			size_t from = Pick(output.size() + 1);
+			output.insert(pos, output.substr(from, Pick(8)));
+		}
+	}
+	return output;
+}
+
+static auto CheckFuzzInputs(void) -> bool
+{
+	// seeded mutations of AFV and TrackAudio messages, parsers never throw and either reject or agree with reference parsers
+	// engine only throws json errors from frame parsing, and keeps valid records
+	const std::vector<std::string> afvStations = { "118.700:True:False", "121.500:False:True", "131.125:True:True", "118.9995:False:False" };
+	const std::vector<std::string> afvTransmitters = { "CPA123:CES456:", "VHHK_APP", "CPA123::UAL789" };
+	const std::vector<std::string> trackAudio = {
+		R"({"type":"kRxBegin","value":{"callsign":"CPA123","pFrequencyHz":118700000}})",
+		R"({"type":"kRxEnd","value":{"callsign":"CES456","pFrequencyHz":118700000}})",
+		R"({"type":"kStationStateUpdate","value":{"callsign":"VHHK_APP","frequency":118700000,"rx":true,"tx":false,"xc":false,"xca":false,"headset":true,"isOutputMuted":false,"outputVolume":100}})",
+		R"({"type":"kStationStates","value":{"stations":[{"type":"kStationStateUpdate","value":{"callsign":"VHHK_APP","frequency":118700000,"rx":true,"tx":true}}]}})"
+	};
+	bool passed = true;
+	check_host host;
+	host.targets["CPA123"] = { { 22.3, 113.9 }, 20000 };
+	host.targets["CES456"] = { { 23.0, 114.5 }, 35000 };
+	host.targets["UAL789"] = { { 21.0, 113.0 }, 10000 };
+	host.controllers["VHHK_APP"] = { 22.3, 114.2 };
+	RDFCommon::plugin_engine engine(host);
+	RDFCommon::random_generator random(23);
+	size_t afvAccepted = 0, afvRejected = 0, decoded = 0, frames = 0, rejectedFrames = 0;
+	for (size_t i = 0; i < 6000; i++) {
+		const auto& corpus = i % 3 == 0 ? afvStations : i % 3 == 1 ? afvTransmitters : trackAudio;
+		auto input = Mutate(corpus[(size_t)(random.Uniform() * (double)corpus.size())], random);
+		try {
+			// AFV bridge parser, accepted frequency must match stod within rounding
+			RDFCommon::chnl_state state;
+			state.frequency = -1;
+			if (RDFCommon::ParseAFVStationState(input, state) == RDFCommon::afv_parse_error::none) {
+				afvAccepted++;
+				auto field = input.substr(0, input.find(':'));
+				bool valid = field.find_first_not_of("0123456789.") == std::string::npos && std::isdigit((unsigned char)field[0]) &&
+					std::abs(state.frequency - FrequencyFromMHz(std::stod(field))) <= 1 &&
+					input.substr(field.size()) == std::string(state.rx ? ":True" : ":False") + (state.tx ? ":True" : ":False");
+				if (!valid) {
+					PLOGE << "self check failed, fuzz ParseAFVStationState accepted: " << input;
+					passed = false;
+				}
+			}
+			else {
+				afvRejected++;
+				if (state.frequency != -1) {
+					PLOGE << "self check failed, fuzz ParseAFVStationState wrote rejected: " << input;
+					passed = false;
+				}
+			}
+			// TrackAudio fast path, decoded frames must read the same through json parser
+			RDFCommon::plugin_event event;
+			if (RDFCommon::DecodeTrackAudioTransmission(input, event)) {
+				decoded++;
+				auto data = nlohmann::json::parse(input);
+				if (data.at("type") != (event.type == RDFCommon::event_type::TrackAudioRxBegin ? "kRxBegin" : "kRxEnd") || data.at("value").at("callsign") != event.message) {
+					PLOGE << "self check failed, fuzz DecodeTrackAudioTransmission: " << input;
+					passed = false;
+				}
+			}
+		}
+		catch (std::exception const& e) {
+			PLOGE << "self check failed, fuzz parser threw: " << input << ", " << e.what();
+			passed = false;
+		}
+		// engine, frame errors are left to the WS handler and rejected messages are logged
+		try {
+			quiet_log quiet;
+			if (corpus == trackAudio) {
+				frames++;
+				try {
+					engine.TrackAudioFrameHandler(input, std::chrono::steady_clock::now());
+				}
+				catch (nlohmann::json::exception const&) {
+					rejectedFrames++;
+				}
+			}
+			else {
+				RDFCommon::plugin_event event;
+				event.type = corpus == afvStations ? RDFCommon::event_type::AFVStationState : RDFCommon::event_type::AFVTransmission;
+				event.message = input;
+				engine.PostEvent(std::move(event));
+			}
+			if (i % 16 == 15) {
+				engine.ProcessEvents(nullptr);
+			}
+		}
+		catch (std::exception const& e) {
+			PLOGE << "self check failed, fuzz engine threw: " << input << ", " << e.what();
+			passed = false;
+		}
+		if (i % 16 == 15) {
+			auto snapshot = engine.GetSnapshot();
+			const auto& records = snapshot->current;
+			bool valid = std::adjacent_find(records.begin(), records.end(), [](const auto& a, const auto& b) { return a.first >= b.first; }) == records.end() &&
+				std::all_of(records.begin(), records.end(), [](const auto& item) { return item.second.radius > 0; });
+			if (!valid) {
+				PLOGE << "self check failed, fuzz records invalid after: " << input;
+				passed = false;
+			}
+		}
+	}
+	// mutations must reach both outcomes, otherwise corpus or mutator is broken
+	if (!afvAccepted || !afvRejected || !decoded || rejectedFrames == frames || !rejectedFrames) {
+		PLOGE << "self check failed, fuzz coverage, AFV accepted: " << afvAccepted << ", rejected: " << afvRejected
+			<< ", decoded: " << decoded << ", frames rejected: " << rejectedFrames << "/" << frames;
+		passed = false;
+	}
+	return passed;
+}
+
+auto RDFCommon::SelfCheck(void) -> bool
+{
+	bool passed = CheckDecodeTrackAudioTransmission();
+	passed = CheckParseAFVStationState() && passed;
+	passed = CheckFindChannel() && passed;
+	passed = CheckReconcileStationStates() && passed;
+	passed = CheckStationCoalescer() && passed;
+	passed = CheckReplayLog() && passed;
+	passed = CheckRandomGenerator() && passed;
+	passed = CheckAddOffsets() && passed;
+	passed = CheckAddRing() && passed;
+	passed = CheckLatencyHistogram() && passed;
+	passed = CheckBoundedQueue() && passed;
+	passed = CheckTrace() && passed;
+	passed = CheckCallsignPositions() && passed;
+	passed = CheckCallsignSet() && passed;
+	passed = CheckFollowTarget() && passed;
+	passed = CheckCallsignCache() && passed;
+	passed = CheckAFVTransmission() && passed;
+	passed = CheckChannelMirror() && passed;
+	passed = CheckFuzzInputs() && passed;
+	PLOGI << "self check " << (passed ? "passed" : "failed");
+	return passed;
+}
+#endif // RDF_SELF_CHECK
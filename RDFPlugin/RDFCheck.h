@@ -0,0 +1,21 @@
+#pragma once
+
+#ifndef RDFCHECK_H
+#define RDFCHECK_H
+
+#include "RDFCore.h"
+
+// Self checks of fast paths against known inputs, built in Debug or with RDF_SELF_CHECK defined
+#if defined(_DEBUG) && !defined(RDF_SELF_CHECK)
+#define RDF_SELF_CHECK
+#endif
+
+namespace RDFCommon {
+
+#ifdef RDF_SELF_CHECK
+	auto SelfCheck(void) -> bool; // failures are logged, return true if all pass
+#endif // RDF_SELF_CHECK
+
+}
+
+#endif // !RDFCHECK_H
@@ -7,7 +7,7 @@ auto RDFCommon::GetRGB(COLORREF& color, const std::string& settingValue) -> bool
 {
 	try {
 		PLOGV << settingValue;
-		std::regex rxRGB(R"(^(\d{1,3}):(\d{1,3}):(\d{1,3})$)");
+		static const std::regex rxRGB(R"(^(\d{1,3}):(\d{1,3}):(\d{1,3})$)");
 		std::smatch match;
 		if (std::regex_match(settingValue, match, rxRGB)) {
 			UINT r = std::stoi(match[1].str());
@@ -24,24 +24,3 @@ auto RDFCommon::GetRGB(COLORREF& color, const std::string& settingValue) -> bool
 	}
 	return false;
 }
-
-auto RDFCommon::AddOffset(EuroScopePlugIn::CPosition& position, const double& heading, const double& distance) -> void
-{
-	// from ES internal void CEuroScopeCoord :: Move ( double heading, double distance )
-	if (distance < 0.000001)
-		return;
-
-	double m_Lat = position.m_Latitude;
-	double m_Lon = position.m_Longitude;
-
-	double distancePerR = distance / EarthRadius;
-	double cosDistancePerR = cos(distancePerR);
-	double sinDistnacePerR = sin(distancePerR);
-
-	double fi2 = asin(sin(GEOM_RAD_FROM_DEG(m_Lat)) * cosDistancePerR + cos(GEOM_RAD_FROM_DEG(m_Lat)) * sinDistnacePerR * cos(GEOM_RAD_FROM_DEG(heading)));
-	double lambda2 = GEOM_RAD_FROM_DEG(m_Lon) + atan2(sin(GEOM_RAD_FROM_DEG(heading)) * sinDistnacePerR * cos(GEOM_RAD_FROM_DEG(m_Lat)),
-		cosDistancePerR - sin(GEOM_RAD_FROM_DEG(m_Lat)) * sin(fi2));
-
-	position.m_Latitude = GEOM_DEG_FROM_RAD(fi2);
-	position.m_Longitude = GEOM_DEG_FROM_RAD(lambda2);
-}
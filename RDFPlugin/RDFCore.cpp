@@ -0,0 +1,865 @@
+#include "RDFCore.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <random>
+#include <tuple>
+#include <utility>
+
+#ifdef RDF_SIMD
+#include <immintrin.h>
+#endif // RDF_SIMD
+
+auto RDFCommon::AddOffset(geo_position& position, const double& heading, const double& distance) -> void
+{
+	// from ES internal void CEuroScopeCoord :: Move ( double heading, double distance )
+	if (distance < 0.000001)
+		return;
+
+	double m_Lat = position.latitude;
+	double m_Lon = position.longitude;
+
+	double distancePerR = distance / EarthRadius;
+	double cosDistancePerR = cos(distancePerR);
+	double sinDistnacePerR = sin(distancePerR);
+
+	double fi2 = asin(sin(GEOM_RAD_FROM_DEG(m_Lat)) * cosDistancePerR + cos(GEOM_RAD_FROM_DEG(m_Lat)) * sinDistnacePerR * cos(GEOM_RAD_FROM_DEG(heading)));
+	double lambda2 = GEOM_RAD_FROM_DEG(m_Lon) + atan2(sin(GEOM_RAD_FROM_DEG(heading)) * sinDistnacePerR * cos(GEOM_RAD_FROM_DEG(m_Lat)),
+		cosDistancePerR - sin(GEOM_RAD_FROM_DEG(m_Lat)) * sin(fi2));
+
+	position.latitude = GEOM_DEG_FROM_RAD(fi2);
+	position.longitude = GEOM_DEG_FROM_RAD(lambda2);
+}
+
+// Per-origin trig of AddOffsets and AddRing
+typedef struct _geo_trig {
+	double sinLat;
+	double cosLat;
+	double lon; // radians
+} geo_trig;
+
+// Per-offset trig of AddOffsets and AddRing, arrays of count elements
+typedef struct _offset_trig {
+	const double* sinHeading;
+	const double* cosHeading;
+	const double* sinDistancePerR;
+	const double* cosDistancePerR;
+	size_t count;
+} offset_trig;
+
+#ifdef RDF_SIMD
+// Lane operations, asin and atan2 come from SVML on MSVC and from SimdAtan2 elsewhere
+struct simd_sse2 {
+	typedef __m128d type;
+	static constexpr size_t lanes = 2;
+	static inline auto Set(const double& v) -> type { return _mm_set1_pd(v); }
+	static inline auto Load(const double* p) -> type { return _mm_loadu_pd(p); }
+	static inline auto Store(double* p, const type& v) -> void { _mm_storeu_pd(p, v); }
+	static inline auto Add(const type& a, const type& b) -> type { return _mm_add_pd(a, b); }
+	static inline auto Sub(const type& a, const type& b) -> type { return _mm_sub_pd(a, b); }
+	static inline auto Mul(const type& a, const type& b) -> type { return _mm_mul_pd(a, b); }
+	static inline auto Div(const type& a, const type& b) -> type { return _mm_div_pd(a, b); }
+	static inline auto Sqrt(const type& a) -> type { return _mm_sqrt_pd(a); }
+	static inline auto And(const type& a, const type& b) -> type { return _mm_and_pd(a, b); }
+	static inline auto Or(const type& a, const type& b) -> type { return _mm_or_pd(a, b); }
+	static inline auto Xor(const type& a, const type& b) -> type { return _mm_xor_pd(a, b); }
+	static inline auto Gt(const type& a, const type& b) -> type { return _mm_cmpgt_pd(a, b); }
+	static inline auto Lt(const type& a, const type& b) -> type { return _mm_cmplt_pd(a, b); }
+	static inline auto Eq(const type& a, const type& b) -> type { return _mm_cmpeq_pd(a, b); }
+	static inline auto Select(const type& mask, const type& a, const type& b) -> type { return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b)); }
+	static inline auto Asin(const type& x) -> type;
+	static inline auto Atan2(const type& y, const type& x) -> type;
+};
+
+#ifdef RDF_SIMD_AVX2
+struct simd_avx2 {
+	typedef __m256d type;
+	static constexpr size_t lanes = 4;
+	static inline auto Set(const double& v) -> type { return _mm256_set1_pd(v); }
+	static inline auto Load(const double* p) -> type { return _mm256_loadu_pd(p); }
+	static inline auto Store(double* p, const type& v) -> void { _mm256_storeu_pd(p, v); }
+	static inline auto Add(const type& a, const type& b) -> type { return _mm256_add_pd(a, b); }
+	static inline auto Sub(const type& a, const type& b) -> type { return _mm256_sub_pd(a, b); }
+	static inline auto Mul(const type& a, const type& b) -> type { return _mm256_mul_pd(a, b); }
+	static inline auto Div(const type& a, const type& b) -> type { return _mm256_div_pd(a, b); }
+	static inline auto Sqrt(const type& a) -> type { return _mm256_sqrt_pd(a); }
+	static inline auto And(const type& a, const type& b) -> type { return _mm256_and_pd(a, b); }
+	static inline auto Or(const type& a, const type& b) -> type { return _mm256_or_pd(a, b); }
+	static inline auto Xor(const type& a, const type& b) -> type { return _mm256_xor_pd(a, b); }
+	static inline auto Gt(const type& a, const type& b) -> type { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+	static inline auto Lt(const type& a, const type& b) -> type { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+	static inline auto Eq(const type& a, const type& b) -> type { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+	static inline auto Select(const type& mask, const type& a, const type& b) -> type { return _mm256_blendv_pd(b, a, mask); }
+	static inline auto Asin(const type& x) -> type;
+	static inline auto Atan2(const type& y, const type& x) -> type;
+};
+#endif // RDF_SIMD_AVX2
+
+#ifndef _MSC_VER
+template<typename S>
+static inline auto SimdAtan(const typename S::type& x) -> typename S::type
+{
+	// Cephes atan: reduce |x| into [0, 0.66], rational approximation, restore sign
+	constexpr double moreBits = 6.123233995736765886130E-17; // pi/2 - (double)(pi/2)
+	const auto sign = S::And(x, S::Set(-0.0));
+	auto a = S::Xor(x, sign);
+	const auto big = S::Gt(a, S::Set(2.41421356237309504880)); // tan(3pi/8)
+	const auto mid = S::Gt(a, S::Set(0.66));
+	auto y = S::Select(big, S::Set(pi / 2), S::Select(mid, S::Set(pi / 4), S::Set(0.0)));
+	auto more = S::Select(big, S::Set(moreBits), S::Select(mid, S::Set(0.5 * moreBits), S::Set(0.0)));
+	a = S::Select(big, S::Div(S::Set(-1.0), a), S::Select(mid, S::Div(S::Sub(a, S::Set(1.0)), S::Add(a, S::Set(1.0))), a));
+	const auto z = S::Mul(a, a);
+	auto p = S::Set(-8.750608600031904122785E-1);
+	p = S::Add(S::Mul(p, z), S::Set(-1.615753718733365076637E1));
+	p = S::Add(S::Mul(p, z), S::Set(-7.500855792314704667340E1));
+	p = S::Add(S::Mul(p, z), S::Set(-1.228866684490136173410E2));
+	p = S::Add(S::Mul(p, z), S::Set(-6.485021904942025371773E1));
+	auto q = S::Add(z, S::Set(2.485846490142306297962E1));
+	q = S::Add(S::Mul(q, z), S::Set(1.650270098316988542046E2));
+	q = S::Add(S::Mul(q, z), S::Set(4.328810604912902668951E2));
+	q = S::Add(S::Mul(q, z), S::Set(4.853903996359136964868E2));
+	q = S::Add(S::Mul(q, z), S::Set(1.945506571482613964425E2));
+	y = S::Add(y, S::Add(S::Add(S::Mul(a, S::Div(S::Mul(z, p), q)), a), more));
+	return S::Xor(y, sign);
+}
+
+template<typename S>
+static inline auto SimdAtan2(const typename S::type& y, const typename S::type& x) -> typename S::type
+{
+	// quadrants as std::atan2, except that atan2(±0, -0) gives ±0
+	const auto zero = S::Set(0.0);
+	const auto ySign = S::And(y, S::Set(-0.0));
+	auto r = S::Add(SimdAtan<S>(S::Div(y, x)), S::And(S::Lt(x, zero), S::Or(S::Set(pi), ySign)));
+	auto onAxis = S::Select(S::Eq(y, zero), ySign, S::Or(S::Set(pi / 2), ySign));
+	return S::Select(S::Eq(x, zero), onAxis, r);
+}
+
+template<typename S>
+static inline auto SimdAsin(const typename S::type& x) -> typename S::type
+{
+	// asin(x) = atan2(x, sqrt(1 - x^2)), factored to keep precision near ±1
+	const auto one = S::Set(1.0);
+	return SimdAtan2<S>(x, S::Sqrt(S::Mul(S::Sub(one, x), S::Add(one, x))));
+}
+#endif // !_MSC_VER
+
+#ifdef _MSC_VER
+inline auto simd_sse2::Asin(const type& x) -> type { return _mm_asin_pd(x); }
+inline auto simd_sse2::Atan2(const type& y, const type& x) -> type { return _mm_atan2_pd(y, x); }
+#ifdef RDF_SIMD_AVX2
+inline auto simd_avx2::Asin(const type& x) -> type { return _mm256_asin_pd(x); }
+inline auto simd_avx2::Atan2(const type& y, const type& x) -> type { return _mm256_atan2_pd(y, x); }
+#endif // RDF_SIMD_AVX2
+#else
+inline auto simd_sse2::Asin(const type& x) -> type { return SimdAsin<simd_sse2>(x); }
+inline auto simd_sse2::Atan2(const type& y, const type& x) -> type { return SimdAtan2<simd_sse2>(y, x); }
+#ifdef RDF_SIMD_AVX2
+inline auto simd_avx2::Asin(const type& x) -> type { return SimdAsin<simd_avx2>(x); }
+inline auto simd_avx2::Atan2(const type& y, const type& x) -> type { return SimdAtan2<simd_avx2>(y, x); }
+#endif // RDF_SIMD_AVX2
+#endif // _MSC_VER
+
+template<typename S>
+static auto MoveOriginSimd(const geo_trig& origin, const offset_trig& trig, RDFCommon::geo_position* positions, size_t i) -> size_t
+{
+	// S::lanes offsets per iteration, return index of first offset left
+	const auto sinLat = S::Set(origin.sinLat);
+	const auto cosLat = S::Set(origin.cosLat);
+	const auto lon = S::Set(origin.lon);
+	const auto degFromRad = S::Set(180.0 / pi);
+	for (; i + S::lanes <= trig.count; i += S::lanes) {
+		const auto sinHeading = S::Load(trig.sinHeading + i);
+		const auto cosHeading = S::Load(trig.cosHeading + i);
+		const auto sinDistancePerR = S::Load(trig.sinDistancePerR + i);
+		const auto cosDistancePerR = S::Load(trig.cosDistancePerR + i);
+		const auto sinFi2 = S::Add(S::Mul(sinLat, cosDistancePerR), S::Mul(S::Mul(cosLat, sinDistancePerR), cosHeading));
+		const auto lambda2 = S::Add(lon, S::Atan2(S::Mul(S::Mul(sinHeading, sinDistancePerR), cosLat), S::Sub(cosDistancePerR, S::Mul(sinLat, sinFi2))));
+		alignas(32) double resLat[S::lanes], resLon[S::lanes];
+		S::Store(resLat, S::Mul(S::Asin(sinFi2), degFromRad));
+		S::Store(resLon, S::Mul(lambda2, degFromRad));
+		for (size_t j = 0; j < S::lanes; j++) {
+			positions[i + j] = { resLat[j], resLon[j] };
+		}
+	}
+	return i;
+}
+#endif // RDF_SIMD
+
+static auto MoveOrigin(const RDFCommon::geo_position& position, const offset_trig& trig, RDFCommon::geo_position* positions) -> void
+{
+	// same formula as AddOffset for every offset, sin(fi2) is taken from asin argument
+	const double lat = GEOM_RAD_FROM_DEG(position.latitude);
+	const geo_trig origin = { sin(lat), cos(lat), GEOM_RAD_FROM_DEG(position.longitude) };
+	size_t i = 0;
+#ifdef RDF_SIMD_AVX2
+	i = MoveOriginSimd<simd_avx2>(origin, trig, positions, i);
+#endif // RDF_SIMD_AVX2
+#ifdef RDF_SIMD
+	i = MoveOriginSimd<simd_sse2>(origin, trig, positions, i);
+#endif // RDF_SIMD
+	for (; i < trig.count; i++) {
+		double sinFi2 = origin.sinLat * trig.cosDistancePerR[i] + origin.cosLat * trig.sinDistancePerR[i] * trig.cosHeading[i];
+		double lambda2 = origin.lon + atan2(trig.sinHeading[i] * trig.sinDistancePerR[i] * origin.cosLat, trig.cosDistancePerR[i] - origin.sinLat * sinFi2);
+		positions[i].latitude = GEOM_DEG_FROM_RAD(asin(sinFi2));
+		positions[i].longitude = GEOM_DEG_FROM_RAD(lambda2);
+	}
+}
+
+auto RDFCommon::AddOffsets(std::span<const geo_position> origins, std::span<const draw_offset> offsets, std::span<geo_position> positions) -> void
+{
+	// trig of each offset is shared by all origins, distances under AddOffset's threshold keep origin
+	if (offsets.empty()) return;
+	const size_t count = (std::min)(origins.size(), positions.size() / offsets.size());
+	thread_local std::vector<double> buffer; // reused, grows to the largest batch
+	buffer.resize(offsets.size() * 4);
+	double* sinHeading = buffer.data();
+	double* cosHeading = sinHeading + offsets.size();
+	double* sinDistancePerR = cosHeading + offsets.size();
+	double* cosDistancePerR = sinDistancePerR + offsets.size();
+	for (size_t i = 0; i < offsets.size(); i++) {
+		double heading = GEOM_RAD_FROM_DEG(offsets[i].bearing);
+		double distancePerR = offsets[i].distance / EarthRadius;
+		sinHeading[i] = sin(heading);
+		cosHeading[i] = cos(heading);
+		sinDistancePerR[i] = sin(distancePerR);
+		cosDistancePerR[i] = cos(distancePerR);
+	}
+	const offset_trig trig = { sinHeading, cosHeading, sinDistancePerR, cosDistancePerR, offsets.size() };
+	for (size_t o = 0; o < count; o++) {
+		auto result = positions.data() + o * offsets.size();
+		MoveOrigin(origins[o], trig, result);
+		for (size_t i = 0; i < offsets.size(); i++) {
+			if (offsets[i].distance < 0.000001) {
+				result[i] = origins[o];
+			}
+		}
+	}
+}
+
+auto RDFCommon::RingLodLevel(const double& pixelRadius) -> size_t
+{
+	// chord error of n-gon is about r * pi^2 / (2 * n^2), keep it under 0.5px
+	double vertices = pi * sqrt((std::max)(pixelRadius, 0.0));
+	size_t level = 0;
+	while (level + 1 < RING_LOD_LEVELS && (double)(RING_LOD_MIN_VERTICES << level) < vertices) {
+		level++;
+	}
+	return level;
+}
+
+auto RDFCommon::GetRingLod(const size_t& level) -> const ring_lod&
+{
+	static const auto tables = [](void) {
+		std::vector<ring_lod> lods(RING_LOD_LEVELS);
+		for (size_t l = 0; l < lods.size(); l++) {
+			size_t vertices = (size_t)RING_LOD_MIN_VERTICES << l;
+			for (size_t i = 0; i < vertices; i++) {
+				double bearing = 2.0 * pi * (double)i / (double)vertices;
+				lods[l].sinBearing.push_back(sin(bearing));
+				lods[l].cosBearing.push_back(cos(bearing));
+			}
+		}
+		return lods;
+		}();
+	return tables[(std::min)(level, tables.size() - 1)];
+}
+
+auto RDFCommon::AddRing(const geo_position& origin, const double& distance, const ring_lod& lod, std::vector<geo_position>& ring) -> void
+{
+	// AddOffsets' kernel with bearings from LOD table and a fixed distance
+	const size_t count = lod.sinBearing.size();
+	ring.assign(count, origin);
+	if (distance < 0.000001) return;
+	const double distancePerR = distance / EarthRadius;
+	thread_local std::vector<double> buffer; // fixed distance trig for every vertex
+	buffer.assign(count, sin(distancePerR));
+	buffer.resize(count * 2, cos(distancePerR));
+	MoveOrigin(origin, { lod.sinBearing.data(), lod.cosBearing.data(), buffer.data(), buffer.data() + count, count }, ring.data());
+}
+
+auto RDFCommon::callsign_table::Intern(const std::string_view& callsign) -> callsign_id
+{
+	auto it = ids.find(callsign);
+	if (it != ids.end()) {
+		return it->second;
+	}
+	callsign_id id;
+	if (released.size()) {
+		id = released.back();
+		released.pop_back();
+		names[id] = callsign;
+	}
+	else {
+		id = (callsign_id)names.size();
+		names.emplace_back(callsign);
+	}
+	ids.emplace(names[id], id);
+	return id;
+}
+
+auto RDFCommon::callsign_table::Release(const callsign_id& id) -> bool
+{
+	if (id >= names.size()) {
+		return false;
+	}
+	auto it = ids.find(names[id]);
+	if (it == ids.end() || it->second != id) {
+		return false; // released before
+	}
+	ids.erase(it);
+	names[id].clear();
+	released.push_back(id);
+	return true;
+}
+
+auto RDFCommon::callsign_table::Find(const std::string_view& callsign) const -> std::optional<callsign_id>
+{
+	auto it = ids.find(callsign);
+	if (it != ids.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+auto RDFCommon::callsign_set::Hash(const std::string_view& callsign) -> uint32_t
+{
+	uint32_t hash = 2166136261u;
+	for (const auto& c : callsign) {
+		hash = (hash ^ (uint8_t)c) * 16777619u;
+	}
+	return hash;
+}
+
+auto RDFCommon::callsign_set::Publish(const std::vector<std::string_view>& callsigns) -> void
+{
+	// slots of older generations count as empty, so no clearing is needed
+	uint32_t gen = generation.load(std::memory_order_relaxed) + 1;
+	generation.store(gen, std::memory_order_relaxed); // odd, readers retry
+	std::atomic_thread_fence(std::memory_order_release);
+	uint64_t tag = (uint64_t)(gen + 1) << 32;
+	size_t count = 0;
+	for (const auto& callsign : callsigns) {
+		if (count >= CALLSIGN_SET_SIZE / 2) {
+			PLOGW << "callsign set is full, " << callsigns.size() - count << " callsigns skipped";
+			break;
+		}
+		uint32_t hash = Hash(callsign);
+		for (size_t i = hash & (CALLSIGN_SET_SIZE - 1);; i = (i + 1) & (CALLSIGN_SET_SIZE - 1)) {
+			uint64_t slot = slots[i].load(std::memory_order_relaxed);
+			if ((slot >> 32) != (gen + 1)) {
+				slots[i].store(tag | hash, std::memory_order_relaxed);
+				count++;
+				break;
+			}
+			if ((uint32_t)slot == hash) break; // duplicated
+		}
+	}
+	generation.store(gen + 1, std::memory_order_release);
+}
+
+auto RDFCommon::callsign_set::Contains(const std::string_view& callsign) const -> bool
+{
+	uint32_t hash = Hash(callsign);
+	for (;;) {
+		uint32_t gen = generation.load(std::memory_order_acquire);
+		if (gen & 1) continue;
+		bool found = false;
+		for (size_t i = hash & (CALLSIGN_SET_SIZE - 1);; i = (i + 1) & (CALLSIGN_SET_SIZE - 1)) {
+			uint64_t slot = slots[i].load(std::memory_order_relaxed);
+			if ((slot >> 32) != gen) break;
+			if ((uint32_t)slot == hash) {
+				found = true;
+				break;
+			}
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (generation.load(std::memory_order_relaxed) == gen) return found;
+	}
+}
+
+static auto LowerBound(const RDFCommon::callsign_position& positions, const RDFCommon::callsign_id& id)
+{
+	return std::lower_bound(positions.begin(), positions.end(), id, [](const auto& item, const RDFCommon::callsign_id& value) {
+		return item.first < value;
+		});
+}
+
+auto RDFCommon::FindPosition(const callsign_position& positions, const callsign_id& id) -> const draw_position*
+{
+	auto it = LowerBound(positions, id);
+	return it != positions.end() && it->first == id ? &it->second : nullptr;
+}
+
+auto RDFCommon::FindPosition(callsign_position& positions, const callsign_id& id) -> draw_position*
+{
+	return const_cast<draw_position*>(FindPosition(std::as_const(positions), id));
+}
+
+auto RDFCommon::InsertPosition(callsign_position& positions, const callsign_id& id, const draw_position& position) -> void
+{
+	auto it = LowerBound(positions, id);
+	if (it != positions.end() && it->first == id) {
+		positions[it - positions.begin()].second = position;
+	}
+	else {
+		positions.insert(positions.begin() + (it - positions.begin()), { id, position });
+	}
+}
+
+auto RDFCommon::ErasePosition(callsign_position& positions, const callsign_id& id) -> bool
+{
+	auto it = LowerBound(positions, id);
+	if (it != positions.end() && it->first == id) {
+		positions.erase(positions.begin() + (it - positions.begin()));
+		return true;
+	}
+	return false;
+}
+
+auto RDFCommon::random_generator::Seed(const uint64_t& seed) -> void
+{
+	// expand seed with splitmix64
+	uint64_t x = seed;
+	for (auto& s : state) {
+		uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		s = z ^ (z >> 31);
+	}
+}
+
+auto RDFCommon::random_generator::Next(void) -> uint64_t
+{
+	const uint64_t result = state[0] + state[3];
+	const uint64_t t = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = (state[3] << 45) | (state[3] >> 19);
+	return result;
+}
+
+auto RDFCommon::random_generator::Offsets(std::span<draw_offset> offsets) -> void
+{
+	// Box-Muller gives a pair of normals, use both
+	for (size_t i = 0; i < offsets.size(); i += 2) {
+		double r = sqrt(-2.0 * log(1.0 - Uniform())); // (0, 1]
+		double theta = 2.0 * pi * Uniform();
+		offsets[i].bearing = 360.0 * Uniform();
+		offsets[i].distance = fabs(r * cos(theta)) / 3.0;
+		if (i + 1 < offsets.size()) {
+			offsets[i + 1].bearing = 360.0 * Uniform();
+			offsets[i + 1].distance = fabs(r * sin(theta)) / 3.0;
+		}
+	}
+}
+
+static std::atomic<uint64_t> randomSeed = 0;
+static std::atomic<bool> randomDeterministic = false;
+static std::atomic<uint32_t> randomEpoch = 0; // bumped on every SetRandomSeed
+
+auto RDFCommon::SetRandomSeed(const std::optional<uint64_t>& seed) -> void
+{
+	randomDeterministic = seed.has_value();
+	randomSeed = seed.value_or(0);
+	randomEpoch++;
+}
+
+auto RDFCommon::GetRandomGenerator(void) -> random_generator&
+{
+	thread_local random_generator generator;
+	thread_local uint32_t epoch = UINT32_MAX;
+	auto current = randomEpoch.load();
+	if (epoch != current) {
+		epoch = current;
+		if (randomDeterministic) {
+			generator.Seed(randomSeed);
+		}
+		else {
+			std::random_device randomDevice;
+			generator.Seed(((uint64_t)randomDevice() << 32) | randomDevice());
+		}
+	}
+	return generator;
+}
+
+auto RDFCommon::BuildChannelIndex(std::vector<chnl_entry>&& channels) -> chnl_index
+{
+	// channels in host order, ordinals and lookup table are filled here
+	chnl_index index;
+	index.channels = std::move(channels);
+	std::vector<size_t> sorted(index.channels.size());
+	for (size_t i = 0; i < sorted.size(); i++) {
+		sorted[i] = i;
+	}
+	std::stable_sort(sorted.begin(), sorted.end(), [&](const auto& i1, const auto& i2) {
+		return index.channels[i1].name < index.channels[i2].name;
+		});
+	int ordinal = -1;
+	for (size_t o = 0; o < sorted.size(); o++) {
+		auto& entry = index.channels[sorted[o]];
+		if (o == 0 || entry.name != index.channels[sorted[o - 1]].name) { // duplicated names share one ordinal
+			ordinal++;
+		}
+		entry.ordinal = ordinal;
+		if (entry.state.isPrim && !index.primOrdinal) {
+			index.primOrdinal = ordinal;
+		}
+	}
+	for (size_t i = 0; i < index.channels.size(); i++) {
+		index.byFrequency.emplace(index.channels[i].state.frequency, i);
+	}
+	index.signature = ChannelSignature(index.channels);
+	index.valid = true;
+	return index;
+}
+
+auto RDFCommon::ChannelSignature(const std::vector<chnl_entry>& channels) -> chnl_signature
+{
+	// must match host implementation
+	chnl_signature signature;
+	signature.count = channels.size();
+	if (channels.size()) {
+		signature.first = channels.front().name;
+		signature.last = channels.back().name;
+	}
+	return signature;
+}
+
+auto RDFCommon::FindChannel(const chnl_index& index, const std::optional<std::string>& callsign, const std::optional<int>& frequency) -> std::optional<size_t>
+{
+	// same selection as walking host channels, return index entry
+	const auto& channels = index.channels;
+	auto MatchFrequency = [&](const size_t& i) -> bool {
+		return FrequencyIsSame(channels[i].state.frequency, *frequency);
+		};
+	if (callsign) {
+		// the first channel name containing callsign in host order, with matching frequency if given
+		for (size_t i = 0; i < channels.size(); i++) {
+			if (channels[i].name.find(*callsign) != std::string::npos && (!frequency || MatchFrequency(i))) {
+				PLOGD << (frequency ? "precise" : "callsign") << " match is found: " << *callsign << " - " << channels[i].state.frequency;
+				return i;
+			}
+		}
+	}
+	if (frequency) {
+		// matching frequency nearest prim in name order, ties go to the smaller name, then host order
+		// without prim, the first one in host order
+		auto Rank = [&](const size_t& i) -> std::tuple<int, int, size_t> {
+			if (!index.primOrdinal) return { 0, 0, i };
+			return { abs(*index.primOrdinal - channels[i].ordinal), channels[i].ordinal, i };
+			};
+		std::optional<size_t> found;
+		auto begin = index.byFrequency.lower_bound(*frequency - 2);
+		auto end = index.byFrequency.upper_bound(*frequency + 2);
+		for (auto it = begin; it != end; it++) {
+			if (MatchFrequency(it->second) && (!found || Rank(it->second) < Rank(*found))) {
+				found = it->second;
+			}
+		}
+		if (found) {
+			PLOGD << "frequency match is found " << (index.primOrdinal ? "nearest" : "without") << " prim, callsign: " << channels[*found].name;
+		}
+		return found;
+	}
+	return std::nullopt;
+}
+
+auto RDFCommon::ReconcileStationStates(const chnl_index& index, const std::vector<station_state>& stations) -> std::vector<std::pair<size_t, chnl_state>>
+{
+	// resolve desired state per channel, later stations override earlier ones
+	// compared with mirrored state, prim/atis channels are never toggled
+	std::vector<std::optional<chnl_state>> desired(index.channels.size());
+	for (auto& station : stations) {
+		auto found = FindChannel(index, station.callsign, station.state.frequency);
+		if (found) {
+			desired[*found] = station.state;
+		}
+	}
+	std::vector<std::pair<size_t, chnl_state>> result;
+	for (size_t i = 0; i < desired.size(); i++) {
+		const auto& state = index.channels[i].state;
+		if (desired[i] && !state.isPrim && !state.isAtis && (desired[i]->rx != state.rx || desired[i]->tx != state.tx)) {
+			result.emplace_back(i, *desired[i]);
+		}
+	}
+	return result;
+}
+
+// Strict scanner over a subset of JSON that json parser surely accepts
+// returns false on anything outside the subset, which is then left to json parser
+constexpr auto RX_DECODE_MAX_DEPTH = 8;
+
+static auto ScanWhitespace(const std::string_view& text, size_t& pos) -> void
+{
+	while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) {
+		pos++;
+	}
+}
+
+static auto ScanString(const std::string_view& text, size_t& pos, std::string_view& str) -> bool
+{
+	// no escapes, control or non-ASCII characters
+	if (pos >= text.size() || text[pos] != '"') return false;
+	size_t begin = ++pos;
+	for (; pos < text.size(); pos++) {
+		auto c = (unsigned char)text[pos];
+		if (c == '"') {
+			str = text.substr(begin, pos - begin);
+			pos++;
+			return true;
+		}
+		if (c == '\\' || c < 0x20 || c >= 0x80) return false;
+	}
+	return false;
+}
+
+static auto ScanInteger(const std::string_view& text, size_t& pos) -> bool
+{
+	// no leading zeros, fractions and exponents are rejected by the caller
+	if (text[pos] == '-') pos++;
+	size_t begin = pos;
+	while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+		pos++;
+	}
+	size_t digits = pos - begin;
+	return digits > 0 && digits <= 18 && (digits == 1 || text[begin] != '0');
+}
+
+static auto ScanLiteral(const std::string_view& text, size_t& pos) -> bool
+{
+	for (const std::string_view literal : { "true", "false", "null" }) {
+		if (text.substr(pos, literal.size()) == literal) {
+			pos += literal.size();
+			return true;
+		}
+	}
+	return false;
+}
+
+static auto ScanObject(const std::string_view& text, size_t& pos, const int& depth, const bool& isValue, std::string_view& type, std::string_view& callsign) -> bool
+{
+	// pos is at '{', top level object has depth 1, isValue for the object of top level "value"
+	// the last duplicate key wins like in json parser, fields of interest are reset by non-string values
+	if (depth > RX_DECODE_MAX_DEPTH) return false;
+	pos++;
+	ScanWhitespace(text, pos);
+	if (pos < text.size() && text[pos] == '}') {
+		pos++;
+		return true;
+	}
+	while (true) {
+		std::string_view key;
+		if (!ScanString(text, pos, key)) return false;
+		ScanWhitespace(text, pos);
+		if (pos >= text.size() || text[pos] != ':') return false;
+		pos++;
+		ScanWhitespace(text, pos);
+		if (pos >= text.size()) return false;
+		std::string_view* field = nullptr;
+		if (depth == 1 && key == "type") {
+			field = &type;
+		}
+		else if (isValue && key == "callsign") {
+			field = &callsign;
+		}
+		else if (depth == 1 && key == "value") {
+			callsign = std::string_view();
+		}
+		char c = text[pos];
+		if (c == '"') {
+			std::string_view str;
+			if (!ScanString(text, pos, str)) return false;
+			if (field) *field = str;
+		}
+		else {
+			if (field) *field = std::string_view();
+			if (c == '{') {
+				if (!ScanObject(text, pos, depth + 1, depth == 1 && key == "value", type, callsign)) return false;
+			}
+			else if (c == '-' || (c >= '0' && c <= '9')) {
+				if (!ScanInteger(text, pos)) return false;
+			}
+			else if (!ScanLiteral(text, pos)) { // arrays included
+				return false;
+			}
+		}
+		ScanWhitespace(text, pos);
+		if (pos >= text.size()) return false;
+		if (text[pos] == '}') {
+			pos++;
+			return true;
+		}
+		if (text[pos] != ',') return false;
+		pos++;
+		ScanWhitespace(text, pos);
+	}
+}
+
+auto RDFCommon::station_coalescer::Push(const station_source& source, const station_state& station) -> void
+{
+	// bursts are short, linear search is enough
+	auto it = std::find_if(pending.begin(), pending.end(), [&station](const auto& item) {
+		return item.second.state.frequency == station.state.frequency && item.second.callsign == station.callsign;
+		});
+	if (it != pending.end()) {
+		*it = { source, station };
+		merged++;
+		return;
+	}
+	if (pending.empty()) {
+		since = std::chrono::steady_clock::now();
+	}
+	pending.emplace_back(source, station);
+}
+
+auto RDFCommon::station_coalescer::Due(const std::chrono::milliseconds& window) const -> bool
+{
+	return pending.size() && std::chrono::steady_clock::now() - since >= window;
+}
+
+auto RDFCommon::station_coalescer::Take(void) -> std::vector<station_state>
+{
+	std::vector<station_state> stations;
+	stations.reserve(pending.size());
+	for (auto& [source, station] : pending) {
+		stations.push_back(std::move(station));
+	}
+	applied += stations.size();
+	pending.clear();
+	return stations;
+}
+
+auto RDFCommon::station_coalescer::Clear(const station_source& source) -> void
+{
+	// window keeps running from the oldest update, remaining ones are only flushed sooner
+	std::erase_if(pending, [&source](const auto& item) {
+		return item.first == source;
+		});
+}
+
+auto RDFCommon::DecodeTrackAudioTransmission(const std::string_view& message, plugin_event& event) -> bool
+{
+	// single pass over {"type":"kRxBegin","value":{"callsign":"XXX",...}}, allocates only for callsign
+	// the frame is validated, anything outside the subset (arrays, escapes, fractions, deep nesting) is left to json parser
+	std::string_view type, callsign;
+	size_t pos = 0;
+	ScanWhitespace(message, pos);
+	if (pos >= message.size() || message[pos] != '{') return false;
+	if (!ScanObject(message, pos, 1, false, type, callsign)) return false;
+	ScanWhitespace(message, pos); // only whitespace may follow the closing brace
+	if (pos != message.size() || callsign.empty()) return false;
+	if (type == "kRxBegin") {
+		event.type = event_type::TrackAudioRxBegin;
+	}
+	else if (type == "kRxEnd") {
+		event.type = event_type::TrackAudioRxEnd;
+	}
+	else {
+		return false;
+	}
+	event.message = callsign;
+	return true;
+}
+
+static auto ParseFrequencyMHz(const std::string_view& str, int& frequency) -> bool
+{
+	// "118.700" -> 118700 kHz, digits beyond kHz are rounded like FrequencyFromMHz
+	auto dot = str.find('.');
+	auto integer = str.substr(0, dot);
+	int mhz = 0;
+	auto [ptr, ec] = std::from_chars(integer.data(), integer.data() + integer.size(), mhz);
+	if (ec != std::errc() || ptr != integer.data() + integer.size() || integer.empty() || mhz < 0 || mhz > INT_MAX / 1000 - 1) {
+		return false;
+	}
+	int khz = 0;
+	int digits = 0;
+	if (dot != std::string_view::npos) {
+		auto fraction = str.substr(dot + 1);
+		for (size_t i = 0; i < fraction.size(); i++) {
+			char c = fraction[i];
+			if (c < '0' || c > '9') {
+				return false;
+			}
+			if (i < 3) {
+				khz = khz * 10 + (c - '0');
+				digits++;
+			}
+			else if (i == 3 && c >= '5') {
+				khz++; // round half up
+			}
+		}
+	}
+	for (; digits < 3; digits++) {
+		khz *= 10;
+	}
+	frequency = mhz * 1000 + khz;
+	return true;
+}
+
+static auto ParseBoolean(const std::string_view& str, bool& value) -> bool
+{
+	// as from C# bool.ToString()
+	if (str == "True") {
+		value = true;
+	}
+	else if (str == "False") {
+		value = false;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+auto RDFCommon::ParseAFVStationState(const std::string_view& message, chnl_state& state) -> afv_parse_error
+{
+	// state is only written when whole message is valid
+	std::array<std::string_view, 3> fields;
+	size_t count = 0;
+	std::string_view remaining = message;
+	while (true) {
+		auto sep = remaining.find(':');
+		if (count >= fields.size()) {
+			return afv_parse_error::fields;
+		}
+		fields[count++] = remaining.substr(0, sep);
+		if (sep == std::string_view::npos) {
+			break;
+		}
+		remaining.remove_prefix(sep + 1);
+	}
+	if (count != fields.size()) {
+		return afv_parse_error::fields;
+	}
+	int frequency;
+	bool rx, tx;
+	if (!ParseFrequencyMHz(fields[0], frequency)) {
+		return afv_parse_error::frequency;
+	}
+	if (!ParseBoolean(fields[1], rx) || !ParseBoolean(fields[2], tx)) {
+		return afv_parse_error::boolean;
+	}
+	state.frequency = frequency;
+	state.rx = rx;
+	state.tx = tx;
+	return afv_parse_error::none;
+}
+
+auto RDFCommon::AFVParseErrorName(const afv_parse_error& error) -> const char*
+{
+	switch (error) {
+	case afv_parse_error::none:
+		return "none";
+	case afv_parse_error::fields:
+		return "incomplete message";
+	case afv_parse_error::frequency:
+		return "invalid frequency";
+	case afv_parse_error::boolean:
+		return "invalid boolean";
+	}
+	return "unknown";
+}
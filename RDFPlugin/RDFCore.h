@@ -0,0 +1,338 @@
+#pragma once
+
+#ifndef RDFCORE_H
+#define RDFCORE_H
+
+// Portable core, no stdafx.h, Windows or EuroScope headers so it also builds with CMake
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <map>
+#include <unordered_map>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <chrono>
+#include <plog/Log.h>
+
+// Global settings
+constexpr auto SETTING_ENABLE_BRIDGE = "Bridge";
+constexpr auto SETTING_RANDOM_SEED = "RandomSeed";
+constexpr auto SETTING_BRIDGE_WINDOW = "BridgeWindow"; // ms
+
+// Constants
+constexpr auto UNKNOWN_ERROR_MSG = "Unknown error!";
+constexpr auto FREQUENCY_REDUNDANT = 199999; // kHz
+constexpr auto EVENT_QUEUE_SIZE = 1024; // power of 2
+constexpr auto CALLSIGN_SET_SIZE = 1024; // power of 2, filled up to half
+constexpr auto CALLSIGN_DATA_TIMEOUT_SEC = 6; // about one position update cycle, older cached data is selected again
+constexpr auto BRIDGE_WINDOW_MS = 50; // station state updates within are coalesced
+constexpr auto pi = 3.141592653589793;
+constexpr auto EarthRadius = 3438.0; // nautical miles, referred to internal CEuroScopeCoord
+constexpr auto RING_LOD_MIN_VERTICES = 16; // vertices of geodesic ring at lowest LOD, doubled every level
+constexpr auto RING_LOD_LEVELS = 4; // 16, 32, 64, 128 vertices
+inline static constexpr auto GEOM_RAD_FROM_DEG(const double& deg) -> double { return deg * pi / 180.0; };
+inline static constexpr auto GEOM_DEG_FROM_RAD(const double& rad) -> double { return rad / pi * 180.0; };
+
+// SIMD batch geodesy on x86 with SSE2, AVX2 when compiled for it, opt out with RDF_NO_SIMD
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)) && !defined(RDF_NO_SIMD)
+#define RDF_SIMD
+#ifdef __AVX2__
+#define RDF_SIMD_AVX2
+#endif
+#endif
+
+// Inline functions
+inline static auto FrequencyFromMHz(const double& freq) -> int { return (int)round(freq * 1000.0); };
+inline static auto FrequencyFromHz(const double& freq) -> int { return (int)round(freq / 1000.0); };
+inline static auto FrequencyIsSame(const auto& freq1, const auto& freq2) -> bool { return abs(freq1 - freq2) <= 2; }; // return true if same frequency, frequency in kHz
+
+namespace RDFCommon {
+
+	// Geographic position in degrees, portable counterpart of EuroScopePlugIn::CPosition
+	typedef struct _geo_position {
+		double latitude = 0.0;
+		double longitude = 0.0;
+	} geo_position;
+
+	auto AddOffset(geo_position& position, const double& heading, const double& distance) -> void;
+
+	// Random offset, bearing in degrees, distance in units of precision
+	typedef struct _draw_offset {
+		double bearing;
+		double distance;
+	} draw_offset;
+
+	// Move each origin by each heading/distance pair, positions[i * offsets.size() + j] is origins[i] moved by offsets[j]
+	// trig of headings and distances is computed once for all origins, trig of latitude once for all offsets
+	auto AddOffsets(std::span<const geo_position> origins, std::span<const draw_offset> offsets, std::span<geo_position> positions) -> void;
+
+	// Unit-bearing table of a geodesic ring, evenly spaced from north
+	typedef struct _ring_lod {
+		std::vector<double> sinBearing;
+		std::vector<double> cosBearing;
+	} ring_lod;
+
+	auto RingLodLevel(const double& pixelRadius) -> size_t; // lowest level keeping chord error within half a pixel
+	auto GetRingLod(const size_t& level) -> const ring_lod&; // static tables, built once
+	auto AddRing(const geo_position& origin, const double& distance, const ring_lod& lod, std::vector<geo_position>& ring) -> void;
+
+	// xoshiro256+ with 32 bytes of state, not thread-safe, use GetRandomGenerator() for per-thread instance
+	class random_generator {
+	private:
+		uint64_t state[4];
+
+	public:
+		explicit random_generator(const uint64_t& seed = 0) { Seed(seed); }
+		auto Seed(const uint64_t& seed) -> void;
+		auto Next(void) -> uint64_t;
+		inline auto Uniform(void) -> double { return (double)(Next() >> 11) * 0x1.0p-53; } // [0, 1)
+		auto Offsets(std::span<draw_offset> offsets) -> void; // bearing uniform, distance |N(0,1)|/3
+		inline auto Offset(void) -> draw_offset { draw_offset offset; Offsets({ &offset, 1 }); return offset; }
+	};
+
+	auto SetRandomSeed(const std::optional<uint64_t>& seed) -> void; // std::nullopt for non-deterministic, reseeds all threads
+	auto GetRandomGenerator(void) -> random_generator&; // thread-local instance
+
+	// Radar target as seen by host, pressure altitude in feet
+	typedef struct _target_data {
+		geo_position position;
+		int altitude = 0;
+	} target_data;
+
+	// Interned callsign, only converted to string at API edges
+	typedef uint32_t callsign_id;
+
+	// Host data of a callsign, copied in callbacks since host handles may dangle once the target is gone
+	typedef struct _callsign_data {
+		std::optional<geo_position> targetPosition; // std::nullopt if no radar target
+		int targetAltitude = 0; // pressure altitude
+		std::chrono::steady_clock::time_point targetUpdated; // never selected if empty
+		std::optional<geo_position> controllerPosition; // std::nullopt if no controller
+		std::chrono::steady_clock::time_point controllerUpdated; // never selected if empty
+		std::optional<callsign_id> stripped; // controller callsign without trailing letter
+	} callsign_data;
+
+	// Draw position
+	typedef struct _draw_position {
+		geo_position position;
+		double radius;
+		std::chrono::steady_clock::time_point arrival; // of the event creating this record
+		std::optional<callsign_id> target; // followed radar target, std::nullopt for fixed position
+		draw_offset offset = { 0.0, 0.0 }; // from target, distance already scaled by precision
+		_draw_position(void) :
+			position(),
+			radius(0) // invalid value
+		{
+		};
+		_draw_position(geo_position _position, double _radius) :
+			position(_position),
+			radius(_radius)
+		{
+		};
+	} draw_position;
+
+	typedef struct _string_hash {
+		using is_transparent = void;
+		inline auto operator()(const std::string_view& s) const -> size_t { return std::hash<std::string_view>{}(s); }
+	} string_hash;
+
+	// Callsign intern table, IDs are reused after release, not thread-safe
+	class callsign_table {
+	private:
+		std::unordered_map<std::string, callsign_id, string_hash, std::equal_to<>> ids;
+		std::vector<std::string> names;
+		std::vector<callsign_id> released;
+
+	public:
+		auto Intern(const std::string_view& callsign) -> callsign_id;
+		auto Find(const std::string_view& callsign) const -> std::optional<callsign_id>; // no allocation
+		auto Release(const callsign_id& id) -> bool; // return false if not interned, caller must drop all references
+		inline auto Name(const callsign_id& id) const -> const std::string& { return names[id]; }
+		inline auto Size(void) const -> size_t { return ids.size(); } // interned callsigns
+		inline auto Slots(void) const -> size_t { return names.size(); } // upper bound of IDs
+	};
+
+	// Published set of callsign hashes, single writer, lock-free and allocation-free readers
+	// Slots are tagged with an even generation, odd generation means publishing (seqlock)
+	class callsign_set {
+	private:
+		std::atomic<uint32_t> generation = 2; // zeroed slots are stale from start
+		std::array<std::atomic<uint64_t>, CALLSIGN_SET_SIZE> slots = {}; // generation << 32 | hash
+
+		static auto Hash(const std::string_view& callsign) -> uint32_t; // FNV-1a
+
+	public:
+		auto Publish(const std::vector<std::string_view>& callsigns) -> void;
+		auto Contains(const std::string_view& callsign) const -> bool;
+		inline auto Generation(void) const -> uint32_t { return generation.load(std::memory_order_acquire); }
+	};
+
+	// Transmission records, flat and sorted by callsign ID
+	typedef std::vector<std::pair<callsign_id, draw_position>> callsign_position;
+
+	auto FindPosition(const callsign_position& positions, const callsign_id& id) -> const draw_position*; // nullptr if not found
+	auto FindPosition(callsign_position& positions, const callsign_id& id) -> draw_position*; // nullptr if not found
+	auto InsertPosition(callsign_position& positions, const callsign_id& id, const draw_position& position) -> void; // insert or assign
+	auto ErasePosition(callsign_position& positions, const callsign_id& id) -> bool; // return true if erased
+
+	// Transmission records, immutable once published
+	typedef struct _transmission_snapshot {
+		callsign_position current;
+		callsign_position previous;
+		uint64_t version;
+		_transmission_snapshot(void) :
+			version(0)
+		{
+		};
+		_transmission_snapshot(const callsign_position& _current, const callsign_position& _previous, const uint64_t& _version) :
+			current(_current),
+			previous(_previous),
+			version(_version)
+		{
+		};
+	} transmission_snapshot;
+
+	// Settings for generating draw positions, see CRDFPlugin::LoadDrawingSettings for schematic
+	typedef struct _position_settings {
+		bool enabled;
+		int circleRadius;
+		int circlePrecision;
+		int circleThreshold;
+		int lowAltitude;
+		int highAltitude;
+		int lowPrecision;
+		int highPrecision;
+		bool drawController;
+
+		_position_settings(void) {
+			enabled = true;
+			circleRadius = 20; // Default: 20 (nautical miles or pixel), range: (0, +inf)
+			circleThreshold = -1; // Default: -1 (always use pixel)
+			circlePrecision = 0; // Default: no offset (nautical miles), range: [0, +inf)
+			lowAltitude = 0; // Default: 0 (feet)
+			lowPrecision = 0; // Default: 0 (nautical miles), range: [0, +inf)
+			highAltitude = 0; // Default: 0 (feet)
+			highPrecision = 0; // Default: 0 (nautical miles), range: [0, +inf)
+			drawController = false;
+		}
+	} position_settings;
+
+	// Frequency & channel state
+	typedef struct _freq_state {
+		std::optional<std::string> callsign; // can be empty
+		bool tx = false;
+	} freq_state;
+
+	typedef struct _es_chnl_state {
+		bool isPrim;
+		bool isAtis;
+		int frequency;
+		bool rx;
+		bool tx;
+
+		_es_chnl_state(void) {
+			isPrim = false;
+			isAtis = false;
+			frequency = FREQUENCY_REDUNDANT;
+			rx = false;
+			tx = false;
+		}
+	} chnl_state;
+
+	typedef struct _station_state {
+		std::optional<std::string> callsign;
+		chnl_state state;
+	} station_state;
+
+	enum class station_source {
+		TrackAudio,
+		AFV
+	};
+
+	// Station state updates waiting to be applied, latest per frequency and callsign, not thread-safe
+	class station_coalescer {
+	private:
+		std::vector<std::pair<station_source, station_state>> pending; // in order of first update
+		std::chrono::steady_clock::time_point since; // of oldest pending update
+
+	public:
+		size_t merged = 0; // updates replaced before applied
+		size_t applied = 0;
+		auto Push(const station_source& source, const station_state& station) -> void;
+		auto Due(const std::chrono::milliseconds& window) const -> bool; // true if window is passed since oldest pending update
+		auto Take(void) -> std::vector<station_state>;
+		auto Clear(const station_source& source) -> void; // discard pending of source, e.g. superseded by its full states
+		inline auto Size(void) const -> size_t { return pending.size(); }
+	};
+
+	// Ground to air channel index, entries in host order, position is the host handle
+	typedef struct _chnl_entry {
+		std::string name;
+		chnl_state state; // mirrors host, refreshed by own toggles and full enumerations
+		int ordinal = 0; // position of name among sorted distinct names, for distance to primary
+	} chnl_entry;
+
+	// Cheap fingerprint of host channel list, compared before enumerating all channels
+	typedef struct _chnl_signature {
+		size_t count = 0;
+		std::string first; // name of first channel in host order
+		std::string last;
+		auto operator==(const _chnl_signature&) const -> bool = default;
+	} chnl_signature;
+
+	typedef struct _chnl_index {
+		bool valid = false;
+		chnl_signature signature; // of channels when indexed
+		std::vector<chnl_entry> channels;
+		std::multimap<int, size_t> byFrequency; // kHz -> channels
+		std::optional<int> primOrdinal;
+	} chnl_index;
+
+	// Channel logic without host API calls
+	auto BuildChannelIndex(std::vector<chnl_entry>&& channels) -> chnl_index;
+	auto ChannelSignature(const std::vector<chnl_entry>& channels) -> chnl_signature;
+	auto FindChannel(const chnl_index& index, const std::optional<std::string>& callsign, const std::optional<int>& frequency) -> std::optional<size_t>;
+	auto ReconcileStationStates(const chnl_index& index, const std::vector<station_state>& stations) -> std::vector<std::pair<size_t, chnl_state>>; // only channels to be toggled
+
+	// Events handed over to host thread
+	enum class event_type {
+		TrackAudioRxBegin,
+		TrackAudioRxEnd,
+		TrackAudioStationStateUpdate,
+		TrackAudioStationStates,
+		AFVTransmission,
+		AFVStationState,
+		MessageSilent, // status messages from other threads
+		MessageDebug,
+		MessageUnread
+	};
+
+	typedef struct _plugin_event {
+		event_type type = event_type::TrackAudioRxBegin;
+		std::string message; // callsign, raw AFV message or status message
+		std::vector<station_state> stations;
+		std::chrono::steady_clock::time_point arrival; // when message is received, set on post if empty
+	} plugin_event;
+
+	// Fast path for "kRxBegin" & "kRxEnd", return false to fall back onto json parser
+	auto DecodeTrackAudioTransmission(const std::string_view& message, plugin_event& event) -> bool;
+
+	// AFV bridge message "xxx.xxx:True:False", frequency in MHz then rx and tx
+	enum class afv_parse_error {
+		none,
+		fields, // not exactly 3 fields, e.g. partial message
+		frequency,
+		boolean
+	};
+
+	auto ParseAFVStationState(const std::string_view& message, chnl_state& state) -> afv_parse_error; // frequency in kHz, no allocation or exception
+	auto AFVParseErrorName(const afv_parse_error& error) -> const char*;
+
+}
+
+#endif // !RDFCORE_H
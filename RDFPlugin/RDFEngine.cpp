@@ -0,0 +1,812 @@
+#include "RDFEngine.h"
+#include <algorithm>
+#include <iomanip>
+#include <iterator>
+#include <ranges>
+#include <sstream>
+
+auto RDFCommon::plugin_engine::LoadBridgeSettings(void) -> void
+{
+	try {
+		auto window = host.GetSetting(SETTING_BRIDGE_WINDOW);
+		windowStation = std::chrono::milliseconds(window ? (std::max)(std::stoi(*window), 0) : BRIDGE_WINDOW_MS);
+		PLOGI << "bridge window: " << windowStation.count() << "ms";
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+		host.DisplayMessage(message_level::Unread, std::string("Error: ") + e.what());
+	}
+	catch (...)
+	{
+		PLOGE << UNKNOWN_ERROR_MSG;
+		host.DisplayMessage(message_level::Unread, UNKNOWN_ERROR_MSG);
+	}
+}
+
+auto RDFCommon::plugin_engine::LoadRandomSeed(void) -> void
+{
+	// fixed seed makes offsets reproducible (e.g. replay), non-deterministic by default
+	std::optional<uint64_t> seed;
+	try {
+		auto setting = host.GetSetting(SETTING_RANDOM_SEED);
+		if (setting && setting->size()) {
+			seed = std::stoull(*setting);
+			PLOGI << "random seed: " << *seed;
+		}
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+	}
+	catch (...)
+	{
+		PLOGE << UNKNOWN_ERROR_MSG;
+	}
+	SetRandomSeed(seed);
+}
+
+auto RDFCommon::plugin_engine::SetPositionSettings(const std::shared_ptr<const position_settings>& settings) -> void
+{
+	std::unique_lock dlock(mtxPositionSettings, std::defer_lock);
+	RDF_TRACE_LOCK(dlock, "lock mtxPositionSettings");
+	currentPositionSettings = settings;
+}
+
+auto RDFCommon::plugin_engine::GetBridgeMode(void) -> bool
+{
+	// true by default
+	try {
+		auto setting = host.GetSetting(SETTING_ENABLE_BRIDGE);
+		if (setting && !std::stoi(*setting)) {
+			PLOGV << "bridge disabled";
+			return false;
+		}
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+	}
+	catch (...)
+	{
+		PLOGE << UNKNOWN_ERROR_MSG;
+	}
+	PLOGV << "bridge enabled";
+	return true;
+}
+
+auto RDFCommon::plugin_engine::SetBridgeMode(const bool& enabled) -> void
+{
+	host.SaveSetting(SETTING_ENABLE_BRIDGE, "Enable bridge", enabled ? "1" : "0");
+}
+
+auto RDFCommon::plugin_engine::GetTrackAudioBridgeMode(void) -> bool
+{
+	return GetBridgeMode()
+#ifndef DEBUG
+		// prevent conflict with multiple ES instances. Since AFV hidden window it unique, only disable TrackAudio
+		&& host.IsDirectConnection()
+#endif // DEBUG
+		;
+}
+
+auto RDFCommon::plugin_engine::PostEvent(plugin_event&& event) -> void
+{
+	// called from any thread, must not touch host API
+	if (event.arrival == std::chrono::steady_clock::time_point()) {
+		event.arrival = std::chrono::steady_clock::now();
+	}
+	if (!queueEvent.push(std::move(event))) {
+		PLOGW << "event queue is full, event dropped";
+	}
+}
+
+auto RDFCommon::plugin_engine::PostStatusMessage(const event_type& type, const std::string& msg) -> void
+{
+	plugin_event event;
+	event.type = type;
+	event.message = msg;
+	PostEvent(std::move(event));
+}
+
+auto RDFCommon::plugin_engine::ProcessEvents(std::vector<double>* latencies) -> bool
+{
+	// host thread only, return true if transmission records are changed
+	if (!queueEvent.size() && !pendingPublish) {
+		FlushStationStates();
+		return false;
+	}
+	RDF_TRACE_SCOPE("ProcessEvents");
+	auto version = publishedTransmission.load()->version;
+	plugin_event event;
+	while (queueEvent.pop(event)) {
+		countEventProcessed++;
+		auto latency = std::chrono::steady_clock::now() - event.arrival;
+		latencyQueue.Record(latency);
+		if (latencies != nullptr) {
+			latencies->push_back(std::chrono::duration<double, std::milli>(latency).count());
+		}
+		arrivalProcessing = event.arrival;
+		try {
+			switch (event.type) {
+			case event_type::TrackAudioRxBegin:
+				TrackAudioTransmissionHandler(event.message, false);
+				break;
+			case event_type::TrackAudioRxEnd:
+				TrackAudioTransmissionHandler(event.message, true);
+				break;
+			case event_type::TrackAudioStationStateUpdate:
+				for (const auto& station : event.stations) {
+					TrackAudioStationStateUpdateHandler(station);
+				}
+				break;
+			case event_type::TrackAudioStationStates:
+				TrackAudioStationStatesHandler(event.stations);
+				break;
+			case event_type::AFVTransmission:
+				AFVTransmissionHandler(event.message);
+				break;
+			case event_type::AFVStationState:
+				AFVStationStateHandler(event.message);
+				break;
+			case event_type::MessageSilent:
+				host.DisplayMessage(message_level::Silent, event.message);
+				break;
+			case event_type::MessageDebug:
+				host.DisplayMessage(message_level::Debug, event.message);
+				break;
+			case event_type::MessageUnread:
+				host.DisplayMessage(message_level::Unread, event.message);
+				break;
+			}
+		}
+		catch (std::exception const& e) {
+			PLOGE << "Error: " << e.what();
+		}
+		catch (...) {
+			PLOGE << UNKNOWN_ERROR_MSG;
+		}
+	}
+	FlushStationStates();
+	if (pendingPublish) { // records followed targets since last publish
+		std::unique_lock tlock(mtxTransmission, std::defer_lock);
+		RDF_TRACE_LOCK(tlock, "lock mtxTransmission");
+		preTransmission = curTransmission;
+		PublishTransmission();
+	}
+	return publishedTransmission.load()->version != version;
+}
+
+auto RDFCommon::plugin_engine::AFVTransmissionHandler(const std::string& message) -> void
+{
+	// AFV resends the full list of transmitters on every change, only differences are processed
+	RDF_TRACE_SCOPE("AFVTransmissionHandler");
+	PLOGD << "AFV message: " << message;
+	std::vector<callsign_id> callsigns;
+	std::string_view remaining = message;
+	while (remaining.size()) {
+		auto token = remaining.substr(0, remaining.find(':'));
+		remaining.remove_prefix((std::min)(token.size() + 1, remaining.size()));
+		if (token.size()) {
+			callsigns.push_back(callsignTable.Intern(token));
+		}
+	}
+	std::sort(callsigns.begin(), callsigns.end());
+	callsigns.erase(std::unique(callsigns.begin(), callsigns.end()), callsigns.end());
+	// sorted merge against current records, so records from TrackAudio are cleared and callsigns failed to draw are retried
+	std::vector<callsign_id> added, removed;
+	std::ranges::set_difference(callsigns, curTransmission | std::views::keys, std::back_inserter(added));
+	std::ranges::set_difference(curTransmission | std::views::keys, callsigns, std::back_inserter(removed));
+	if (added.empty() && removed.empty()) {
+		return;
+	}
+	std::unique_lock tlock(mtxTransmission, std::defer_lock);
+	RDF_TRACE_LOCK(tlock, "lock mtxTransmission");
+	bool changed = false;
+	for (const auto& id : removed) {
+		changed |= ErasePosition(curTransmission, id);
+	}
+	std::vector<draw_offset> offsets(added.size());
+	GetRandomGenerator().Offsets(offsets);
+	for (size_t i = 0; i < added.size(); i++) {
+		auto dp = GenerateDrawPosition(added[i], offsets[i]);
+		if (dp.radius > 0) {
+			InsertTransmission(added[i], dp);
+			changed = true;
+		}
+	}
+	if (!changed) {
+		return;
+	}
+	if (callsigns.size()) { // empty list keeps previous records
+		preTransmission = curTransmission;
+	}
+	PublishTransmission();
+}
+
+auto RDFCommon::plugin_engine::AFVStationStateHandler(const std::string& message) -> void
+{
+	// functions as AFV bridge
+	PLOGD << "AFV message: " << message;
+	if (!GetBridgeMode() || !message.size()) return;
+	// format: xxx.xxx:True:False + xxx.xx0:True:False
+	chnl_state state;
+	auto error = ParseAFVStationState(message, state);
+	if (error != afv_parse_error::none) {
+		PLOGE << "AFV msg parse error: " << message << ", " << AFVParseErrorName(error);
+		return;
+	}
+
+	// update channel after coalescing
+	coalescerStation.Push(station_source::AFV, { std::nullopt, state });
+}
+
+auto RDFCommon::plugin_engine::GenerateDrawPosition(const callsign_id& callsign, const draw_offset& offset) -> draw_position
+{
+	// return radius=0 for no draw, offset distance is scaled by precision
+	RDF_TRACE_SCOPE("GenerateDrawPosition");
+	try
+	{
+		auto data = SelectData(callsign);
+		auto target = callsign;
+		if (!data.targetPosition && data.controllerPosition && data.stripped) {
+			// find again with last character dumped
+			target = *data.stripped;
+			auto stripped = SelectData(target);
+			data.targetPosition = stripped.targetPosition;
+			data.targetAltitude = stripped.targetAltitude;
+		}
+		std::shared_lock dlock(mtxPositionSettings, std::defer_lock);
+		RDF_TRACE_LOCK(dlock, "lock mtxPositionSettings");
+		bool enableDraw = currentPositionSettings->enabled;
+		int circleRadius = currentPositionSettings->circleRadius;
+		int circlePrecision = currentPositionSettings->circlePrecision;
+		int circleThreshold = currentPositionSettings->circleThreshold;
+		int lowAltitude = currentPositionSettings->lowAltitude;
+		int highAltitude = currentPositionSettings->highAltitude;
+		int lowPrecision = currentPositionSettings->lowPrecision;
+		int highPrecision = currentPositionSettings->highPrecision;
+		bool drawController = currentPositionSettings->drawController;
+		dlock.unlock();
+		if (data.targetPosition && enableDraw) {
+			int alt = data.targetAltitude;
+			if (alt >= lowAltitude) { // need to draw, see Schematic in LoadSettings
+				geo_position pos = *data.targetPosition;
+				double radius = circleRadius;
+				// determines precision
+				double precision = circlePrecision;
+				if (circleThreshold >= 0 && (lowPrecision > 0 || circlePrecision > 0)) {
+					if (highPrecision > 0 && highAltitude > lowAltitude) {
+						precision = (double)lowPrecision + (double)(alt - lowAltitude) * (double)(highPrecision - lowPrecision) / (double)(highAltitude - lowAltitude);
+					}
+					else {
+						precision = lowPrecision > 0 ? lowPrecision : circlePrecision;
+					}
+					radius = precision;
+				}
+				draw_offset scaled = { offset.bearing, 0.0 };
+				if (precision > 0) { // add random offset
+					scaled.distance = offset.distance * precision;
+					AddOffset(pos, scaled.bearing, scaled.distance);
+				}
+				// keep the offset so the record can follow the target
+				draw_position dp(pos, radius);
+				dp.target = target;
+				dp.offset = scaled;
+				return dp;
+			}
+		}
+		else if (drawController && data.controllerPosition) {
+			return draw_position(*data.controllerPosition, circleRadius);
+		}
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+	}
+	catch (...)
+	{
+		PLOGE << UNKNOWN_ERROR_MSG;
+	}
+	return draw_position();
+}
+
+auto RDFCommon::plugin_engine::TrackAudioTransmissionHandler(const std::string& callsign, const bool& rxEnd) -> void
+{
+	// handler for "kRxBegin" & "kRxEnd"
+	// pass rxEnd = true for "kRxEnd"
+	std::unique_lock tlock(mtxTransmission, std::defer_lock);
+	RDF_TRACE_LOCK(tlock, "lock mtxTransmission");
+	bool changed = false;
+	auto id = callsignTable.Intern(callsign);
+	if (FindPosition(curTransmission, id) != nullptr) {
+		if (rxEnd) {
+			ErasePosition(curTransmission, id);
+			changed = true;
+		}
+	}
+	else if (!rxEnd) {
+		auto dp = GenerateDrawPosition(id, GetRandomGenerator().Offset());
+		if (dp.radius > 0) {
+			InsertTransmission(id, dp);
+			changed = true;
+		}
+	}
+	if (!changed) {
+		return; // repeated RX begin/end, nothing for screens to redraw
+	}
+	if (curTransmission.size()) {
+		preTransmission = curTransmission;
+	}
+	PublishTransmission();
+}
+
+auto RDFCommon::plugin_engine::TrackAudioStationStatesHandler(const std::vector<station_state>& stations) -> void
+{
+	// handler for "kStationStates" <- "kGetStationStates" process
+	// reconcile all station states with host channels in one pass
+	// frequencies in kHz
+	if (!GetTrackAudioBridgeMode()) return;
+	coalescerStation.Clear(station_source::TrackAudio); // superseded, AFV updates are kept
+	ScanGroundToAirChannels(false); // full states are compared with fresh mirror
+	for (const auto& [i, state] : ReconcileStationStates(channelIndex, stations)) {
+		ToggleChannel(i, state.rx, state.tx);
+	}
+}
+
+auto RDFCommon::plugin_engine::TrackAudioStationStateUpdateHandler(const station_state& station) -> void
+{
+	// handler for "kStationStateUpdate"
+	// used for update message and for "kStationStates" sections
+	// frequencies in kHz
+	if (!GetTrackAudioBridgeMode()) return;
+	coalescerStation.Push(station_source::TrackAudio, station);
+}
+
+auto RDFCommon::plugin_engine::FlushStationStates(void) -> void
+{
+	// apply coalesced station state updates once window is passed since the oldest
+	if (!coalescerStation.Due(windowStation)) return;
+	RDF_TRACE_SCOPE("FlushStationStates");
+	IndexGroundToAirChannels(false); // once per burst, only reads channel states if list is changed
+	for (const auto& station : coalescerStation.Take()) {
+		UpdateChannel(station.callsign, station.state);
+	}
+}
+
+auto RDFCommon::plugin_engine::TrackAudioStationState(const nlohmann::json& data) -> station_state
+{
+	// parse "kStationStateUpdate" value, safe to call on any thread
+	// data is json["value"]
+	station_state station;
+	std::string callsign = data.value("callsign", "");
+	if (callsign.size()) {
+		station.callsign = callsign;
+	}
+	station.state.frequency = FrequencyFromHz(data.value("frequency", FREQUENCY_REDUNDANT));
+	station.state.rx = data.value("rx", false);
+	station.state.tx = data.value("tx", false);
+	return station;
+}
+
+auto RDFCommon::plugin_engine::IndexGroundToAirChannels(const bool& force) -> void
+{
+	// signature is cheap enough for every timer tick, channels are only enumerated if it is changed
+	if (!force && channelIndex.valid && host.GetChannelSignature() == channelIndex.signature) return;
+	ScanGroundToAirChannels(force);
+}
+
+auto RDFCommon::plugin_engine::ScanGroundToAirChannels(const bool& rebuild) -> void
+{
+	// validate index against host in one pass, rebuild only if channel list is changed
+	// rx/tx/atis of unchanged channels are refreshed on the way
+	host.EnumerateChannels(channelScan);
+	if (!rebuild && channelIndex.valid && channelScan.size() == channelIndex.channels.size()) {
+		bool changed = false;
+		for (size_t i = 0; i < channelScan.size() && !changed; i++) {
+			const auto& scan = channelScan[i];
+			auto& entry = channelIndex.channels[i];
+			changed = entry.name != scan.name ||
+				entry.state.frequency != scan.state.frequency ||
+				entry.state.isPrim != scan.state.isPrim;
+			if (!changed) {
+				entry.state.isAtis = scan.state.isAtis;
+				entry.state.rx = scan.state.rx;
+				entry.state.tx = scan.state.tx;
+			}
+		}
+		if (!changed) return;
+	}
+
+	PLOGD << "indexing ground to air channels";
+	channelIndex = BuildChannelIndex(std::vector<chnl_entry>(channelScan));
+	PLOGD << "channels indexed: " << channelIndex.channels.size();
+}
+
+auto RDFCommon::plugin_engine::SelectGroundToAirChannel(const std::optional<std::string>& callsign, const std::optional<int>& frequency) -> std::optional<size_t>
+{
+	RDF_TRACE_SCOPE("SelectGroundToAirChannel");
+	if (!channelIndex.valid) {
+		IndexGroundToAirChannels(true);
+	}
+	auto found = FindChannel(channelIndex, callsign, frequency);
+	if (found) {
+		// handle is a position in host list, reindex once if it went stale
+		if (host.IsChannel(*found, channelIndex.channels[*found].name)) {
+			return found;
+		}
+		PLOGD << "channel index is outdated";
+		IndexGroundToAirChannels(true);
+		found = FindChannel(channelIndex, callsign, frequency);
+		if (found) {
+			return found;
+		}
+	}
+	PLOGD << "not found";
+	return std::nullopt;
+}
+
+auto RDFCommon::plugin_engine::UpdateChannel(const std::optional<std::string>& callsign, const std::optional<chnl_state>& channelState) -> void
+{
+	// note: EuroScope channels allow duplication in channel name, but name <-> frequency pair is unique.
+	RDF_TRACE_SCOPE("UpdateChannel");
+	if (channelState) {
+		PLOGD << callsign.value_or("NULL") << " - " << channelState->frequency;
+		auto found = SelectGroundToAirChannel(callsign, channelState->frequency);
+		if (found) {
+			ToggleChannel(*found, channelState->rx, channelState->tx);
+		}
+	}
+	else { // doesn't specify channel or frequency, deactivate all channels
+		PLOGD << "deactivating all";
+		ScanGroundToAirChannels(false); // one enumeration, then only channels still active are toggled
+		for (size_t i = 0; i < channelIndex.channels.size(); i++) {
+			ToggleChannel(i, false, false); // check for prim/atis will be done inside
+		}
+	}
+}
+
+auto RDFCommon::plugin_engine::ToggleChannel(const size_t& entry, const std::optional<bool>& rx, const std::optional<bool>& tx) -> void
+{
+	// decided on mirrored state, host is only read around a real toggle since it can't set a state
+	auto& item = channelIndex.channels[entry];
+	auto& state = item.state;
+	auto Differs = [&](void) -> bool {
+		return !state.isAtis && !state.isPrim && ((rx && *rx != state.rx) || (tx && *tx != state.tx));
+		};
+	if (!Differs()) return;
+	if (!RefreshChannel(entry)) {
+		PLOGD << "invalid channel handle, skipping";
+		return;
+	}
+	if (!Differs()) {
+		PLOGD << "skipping, atis: " << state.isAtis << " prim: " << state.isPrim << " or changed by user";
+		return;
+	}
+	if (rx && *rx != state.rx) {
+		host.ToggleTextReceive(entry);
+		std::string logMsg = "RX toggle: " + item.name + " frequency: " + std::to_string(state.frequency / 1000.0) + " ";
+		PLOGI << logMsg;
+		host.DisplayMessage(message_level::Debug, logMsg);
+	}
+	if (tx && *tx != state.tx) {
+		host.ToggleTextTransmit(entry);
+		std::string logMsg = "TX toggle: " + item.name + " frequency: " + std::to_string(state.frequency / 1000.0) + " ";
+		PLOGI << logMsg;
+		host.DisplayMessage(message_level::Debug, logMsg);
+	}
+	RefreshChannel(entry); // read back, one toggle may affect the other
+}
+
+auto RDFCommon::plugin_engine::RefreshChannel(const size_t& entry) -> bool
+{
+	// flags only, frequency stays as indexed for lookup
+	auto live = host.GetChannelState(entry);
+	if (!live) return false;
+	auto& state = channelIndex.channels[entry].state;
+	state.isPrim = live->isPrim;
+	state.isAtis = live->isAtis;
+	state.rx = live->rx;
+	state.tx = live->tx;
+	return true;
+}
+
+auto RDFCommon::plugin_engine::PublishTransmission(void) -> void
+{
+	// readers keep their own reference, so old snapshots stay valid until released
+	auto version = publishedTransmission.load()->version + 1;
+	publishedTransmission.store(std::make_shared<const transmission_snapshot>(curTransmission, preTransmission, version));
+	pendingPublish = false;
+	IndexFollowers();
+	std::vector<std::string_view> callsigns;
+	callsigns.reserve(preTransmission.size());
+	for (const auto& [id, dp] : preTransmission) {
+		callsigns.push_back(callsignTable.Name(id));
+	}
+	preCallsigns.Publish(callsigns);
+	PLOGV << "transmission snapshot published, version: " << version;
+}
+
+auto RDFCommon::plugin_engine::IndexFollowers(void) -> void
+{
+	// records may be added or removed on every publish, capacity is reused
+	followTransmission.clear();
+	for (const auto& [callsign, dp] : curTransmission) {
+		if (dp.target) {
+			followTransmission.emplace_back(*dp.target, callsign);
+		}
+	}
+	std::sort(followTransmission.begin(), followTransmission.end());
+}
+
+auto RDFCommon::plugin_engine::CacheRadarTarget(const callsign_id& callsign, const std::optional<target_data>& target) -> void
+{
+	// target must be fresh from host, std::nullopt is cached as absent
+	auto& data = dataCache[callsign];
+	data.targetPosition.reset();
+	if (target) {
+		data.targetPosition = target->position;
+		data.targetAltitude = target->altitude;
+	}
+	data.targetUpdated = std::chrono::steady_clock::now();
+}
+
+auto RDFCommon::plugin_engine::CacheController(const callsign_id& callsign, const std::optional<geo_position>& position) -> void
+{
+	// position must be fresh from host, std::nullopt is cached as absent
+	auto& data = dataCache[callsign];
+	data.controllerPosition = position;
+	data.controllerUpdated = std::chrono::steady_clock::now();
+	const auto& name = callsignTable.Name(callsign);
+	if (position && !data.stripped && name.size() > 1 && name.back() >= 'A' && name.back() <= 'Z') {
+		// precompute fallback, copied since interning may move names
+		data.stripped = callsignTable.Intern(std::string(name, 0, name.size() - 1));
+	}
+}
+
+auto RDFCommon::plugin_engine::SelectData(const callsign_id& callsign) -> callsign_data
+{
+	// cached data first, host API only if a radar target has no update within one cycle
+	// or the callsign was never seen, absent controllers report themselves by OnControllerPositionUpdate
+	auto now = std::chrono::steady_clock::now();
+	auto timeout = std::chrono::seconds(CALLSIGN_DATA_TIMEOUT_SEC);
+	auto& data = dataCache[callsign];
+	bool selectRadarTarget = now - data.targetUpdated > timeout;
+	bool selectController = data.controllerUpdated == std::chrono::steady_clock::time_point() || (data.controllerPosition && now - data.controllerUpdated > timeout);
+	if (selectRadarTarget || selectController) {
+		RDF_TRACE_SCOPE("SelectData API");
+		const auto& name = callsignTable.Name(callsign);
+		if (selectRadarTarget) {
+			CacheRadarTarget(callsign, host.SelectRadarTarget(name));
+		}
+		if (selectController) {
+			CacheController(callsign, host.SelectController(name));
+		}
+	}
+	return dataCache[callsign];
+}
+
+auto RDFCommon::plugin_engine::OnControllerPositionUpdate(const std::string_view& callsign, const geo_position& position) -> void
+{
+	try
+	{
+		CacheController(callsignTable.Intern(callsign), position);
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+	}
+	catch (...)
+	{
+		PLOGE << UNKNOWN_ERROR_MSG;
+	}
+}
+
+auto RDFCommon::plugin_engine::OnControllerDisconnect(const std::string_view& callsign) -> void
+{
+	auto id = callsignTable.Find(callsign);
+	if (!id) {
+		return;
+	}
+	auto it = dataCache.find(*id);
+	if (it != dataCache.end()) {
+		it->second.controllerPosition.reset();
+		it->second.controllerUpdated = std::chrono::steady_clock::now();
+	}
+}
+
+auto RDFCommon::plugin_engine::OnFlightPlanDisconnect(const std::string_view& callsign) -> void
+{
+	// radar targets have no disconnect callback, their pilots' flight plans do
+	auto id = callsignTable.Find(callsign);
+	if (!id) {
+		return;
+	}
+	auto it = dataCache.find(*id);
+	if (it != dataCache.end()) {
+		it->second.targetPosition.reset();
+		it->second.targetUpdated = std::chrono::steady_clock::now();
+	}
+}
+
+auto RDFCommon::plugin_engine::PruneCallsigns(const std::chrono::steady_clock::time_point& now) -> void
+{
+	// data not updated within one cycle would be selected again anyway, absent controllers are kept with their targets
+	RDF_TRACE_SCOPE("PruneCallsigns");
+	auto timeout = std::chrono::seconds(CALLSIGN_DATA_TIMEOUT_SEC);
+	size_t cached = dataCache.size();
+	std::erase_if(dataCache, [&](const auto& item) {
+		const auto& data = item.second;
+		return now - data.targetUpdated > timeout && (!data.controllerPosition || now - data.controllerUpdated > timeout);
+		});
+	// release callsigns no longer referenced by cache or records, records are only written on host thread
+	std::vector<bool> used(callsignTable.Slots(), false);
+	for (const auto& [callsign, data] : dataCache) {
+		used[callsign] = true;
+		if (data.stripped) {
+			used[*data.stripped] = true;
+		}
+	}
+	for (const auto* records : { &curTransmission, &preTransmission }) {
+		for (const auto& [callsign, dp] : *records) {
+			used[callsign] = true;
+			if (dp.target) {
+				used[*dp.target] = true;
+			}
+		}
+	}
+	size_t released = 0;
+	for (callsign_id id = 0; id < (callsign_id)used.size(); id++) {
+		if (!used[id] && callsignTable.Release(id)) {
+			released++;
+		}
+	}
+	if (released || cached != dataCache.size()) {
+		PLOGV << "callsigns pruned, data: " << cached - dataCache.size() << ", released: " << released << ", interned: " << callsignTable.Size();
+	}
+}
+
+auto RDFCommon::plugin_engine::OnRadarTargetPositionUpdate(const std::string_view& callsign, const target_data& target) -> void
+{
+	// keep data cache, and follow radar targets of active transmissions published once by next ProcessEvents
+	RDF_TRACE_SCOPE("OnRadarTargetPositionUpdate");
+	try
+	{
+		auto id = callsignTable.Intern(callsign);
+		CacheRadarTarget(id, target);
+		if (followTransmission.empty()) {
+			return; // no transmission, or none from a radar target
+		}
+		auto followers = std::ranges::equal_range(followTransmission, id, {}, &std::pair<callsign_id, callsign_id>::first);
+		if (followers.empty()) {
+			return;
+		}
+		std::unique_lock tlock(mtxTransmission, std::defer_lock);
+		RDF_TRACE_LOCK(tlock, "lock mtxTransmission");
+		for (const auto& [followed, transmitter] : followers) {
+			auto dp = FindPosition(curTransmission, transmitter);
+			if (dp != nullptr) {
+				dp->position = target.position;
+				AddOffset(dp->position, dp->offset.bearing, dp->offset.distance);
+				pendingPublish = true;
+			}
+		}
+	}
+	catch (std::exception const& e)
+	{
+		PLOGE << "Error: " << e.what();
+	}
+	catch (...)
+	{
+		PLOGE << UNKNOWN_ERROR_MSG;
+	}
+}
+
+auto RDFCommon::plugin_engine::ClearTransmission(void) -> void
+{
+	PLOGD << "clearing records";
+	std::unique_lock tlock(mtxTransmission);
+	curTransmission.clear();
+	preTransmission.clear();
+	PublishTransmission();
+}
+
+auto RDFCommon::plugin_engine::TrackAudioFrameHandler(const std::string& message, const std::chrono::steady_clock::time_point& arrival) -> void
+{
+	// parse WS message and post event, safe to call on any thread
+	PLOGD << "WS MSG: " << message;
+	plugin_event event;
+	event.arrival = arrival;
+	if (DecodeTrackAudioTransmission(message, event)) {
+		PostEvent(std::move(event));
+		return;
+	}
+	nlohmann::json data;
+	{
+		RDF_TRACE_SCOPE("json parse");
+		data = nlohmann::json::parse(message);
+	}
+	std::string msgType = data["type"];
+	const nlohmann::json& msgValue = data["value"];
+	if (msgType == "kRxBegin") {
+		event.type = event_type::TrackAudioRxBegin;
+		event.message = msgValue.at("callsign");
+	}
+	else if (msgType == "kRxEnd") {
+		event.type = event_type::TrackAudioRxEnd;
+		event.message = msgValue.at("callsign");
+	}
+	else if (msgType == "kStationStateUpdate") { // only handle with sync on
+		event.type = event_type::TrackAudioStationStateUpdate;
+		event.stations.push_back(TrackAudioStationState(msgValue));
+	}
+	else if (msgType == "kStationStates") {// only handle with sync on
+		event.type = event_type::TrackAudioStationStates;
+		for (auto& station : msgValue.at("stations")) {
+			if (station.at("type") == "kStationStateUpdate") {
+				event.stations.push_back(TrackAudioStationState(station.at("value")));
+			}
+		}
+	}
+	else {
+		return;
+	}
+	PostEvent(std::move(event));
+}
+
+auto RDFCommon::plugin_engine::InsertTransmission(const callsign_id& callsign, draw_position drawPosition) -> void
+{
+	drawPosition.arrival = arrivalProcessing;
+	latencyInsert.Record(std::chrono::steady_clock::now() - arrivalProcessing);
+	InsertPosition(curTransmission, callsign, drawPosition);
+}
+
+auto RDFCommon::plugin_engine::IsPreviousTransmitter(const std::string_view& callsign) const -> bool
+{
+	// called for every tag on every refresh, no lock or allocation
+	return preCallsigns.Contains(callsign);
+}
+
+auto RDFCommon::plugin_engine::RecordDrawLatency(const callsign_position& drawPosition) -> void
+{
+	// called by screens after drawing, only records newer than last drawn are counted
+	auto now = std::chrono::steady_clock::now();
+	auto latest = arrivalDrawn;
+	for (const auto& [callsign, dp] : drawPosition) {
+		if (dp.arrival > arrivalDrawn) {
+			latencyDraw.Record(now - dp.arrival);
+			latest = (std::max)(latest, dp.arrival);
+		}
+	}
+	arrivalDrawn = latest;
+}
+
+auto RDFCommon::plugin_engine::ReportStats(void) -> void
+{
+	auto Format = [](const std::string& stage, const latency_histogram& histogram) -> std::string {
+		std::ostringstream line;
+		line << stage << ": " << histogram.Count() << ", p50/p99/max: " << std::fixed << std::setprecision(3)
+			<< histogram.Percentile(0.5) << "/" << histogram.Percentile(0.99) << "/" << histogram.Max() << "ms";
+		return line.str();
+		};
+	std::vector<std::string> lines = {
+		"Events processed: " + std::to_string(countEventProcessed) + ", dropped: " + std::to_string(queueEvent.drops()) + ", queue depth: " + std::to_string(queueEvent.size()) + ".",
+		"Station updates applied: " + std::to_string(coalescerStation.applied) + ", merged: " + std::to_string(coalescerStation.merged) + ".",
+		Format("Arrival to dequeue", latencyQueue),
+		Format("Arrival to record", latencyInsert),
+		Format("Arrival to first draw", latencyDraw)
+	};
+	for (const auto& line : lines) {
+		PLOGI << line;
+		host.DisplayMessage(message_level::Silent, line);
+	}
+}
+
+auto RDFCommon::plugin_engine::ResetStats(void) -> void
+{
+	latencyQueue.Reset();
+	latencyInsert.Reset();
+	latencyDraw.Reset();
+	coalescerStation.applied = 0;
+	coalescerStation.merged = 0;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#ifndef RDFENGINE_H
+#define RDFENGINE_H
+
+#include "RDFCore.h"
+#include "RDFHost.h"
+#include "RDFQueue.h"
+#include "RDFStats.h"
+#include "RDFTrace.h"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <nlohmann/json.hpp>
+
+namespace RDFCommon {
+
+	// Transmission records and bridge logic of the plugin, independent of EuroScope
+	// Host API is only called on host thread, i.e. from ProcessEvents and On* callbacks
+	class plugin_engine {
+	private:
+		plugin_host& host;
+
+		// drawing params
+		std::shared_mutex mtxPositionSettings;
+		std::shared_ptr<const position_settings> currentPositionSettings = std::make_shared<const position_settings>(); // follows the last refreshed screen
+
+		// drawing records
+		std::shared_mutex mtxTransmission; // guards writers, readers use the published snapshot
+		callsign_table callsignTable; // host thread only
+		callsign_position curTransmission;
+		callsign_position preTransmission;
+		callsign_set preCallsigns; // for tag items, follows preTransmission
+		std::vector<std::pair<callsign_id, callsign_id>> followTransmission; // (radar target, record) of curTransmission, sorted by target
+		bool pendingPublish = false; // records moved with their targets, host thread only
+		std::atomic<std::shared_ptr<const transmission_snapshot>> publishedTransmission = std::make_shared<const transmission_snapshot>();
+		auto PublishTransmission(void) -> void; // call with mtxTransmission locked
+		auto IndexFollowers(void) -> void; // call with mtxTransmission locked
+
+		// events from other threads, processed on host thread
+		bounded_queue<plugin_event, EVENT_QUEUE_SIZE> queueEvent;
+		size_t countEventProcessed = 0;
+
+		// latency from message arrival, host thread only
+		latency_histogram latencyQueue; // until dequeued
+		latency_histogram latencyInsert; // until inserted into records
+		latency_histogram latencyDraw; // until first drawn by any screen
+		std::chrono::steady_clock::time_point arrivalProcessing; // of the event being processed
+		std::chrono::steady_clock::time_point arrivalDrawn; // latest drawn record
+		auto InsertTransmission(const callsign_id& callsign, draw_position drawPosition) -> void; // call with mtxTransmission locked
+
+		// host data by callsign, host thread only
+		std::unordered_map<callsign_id, callsign_data> dataCache;
+		auto CacheRadarTarget(const callsign_id& callsign, const std::optional<target_data>& target) -> void;
+		auto CacheController(const callsign_id& callsign, const std::optional<geo_position>& position) -> void;
+		auto SelectData(const callsign_id& callsign) -> callsign_data;
+
+		// ground to air channels, host thread only
+		chnl_index channelIndex;
+		std::vector<chnl_entry> channelScan; // reused by revalidation
+		station_coalescer coalescerStation;
+		std::chrono::milliseconds windowStation = std::chrono::milliseconds(BRIDGE_WINDOW_MS);
+		auto FlushStationStates(void) -> void;
+		auto SelectGroundToAirChannel(const std::optional<std::string>& callsign, const std::optional<int>& frequency) -> std::optional<size_t>; // entry of channelIndex
+		auto ScanGroundToAirChannels(const bool& rebuild) -> void; // enumerates all channels, refreshes mirror
+		auto RefreshChannel(const size_t& entry) -> bool; // reads one channel into mirror, false if handle is invalid
+		auto ToggleChannel(const size_t& entry, const std::optional<bool>& rx, const std::optional<bool>& tx) -> void; // only if mirror differs
+
+		// handlers
+		auto GenerateDrawPosition(const callsign_id& callsign, const draw_offset& offset) -> draw_position;
+		auto TrackAudioTransmissionHandler(const std::string& callsign, const bool& rxEnd) -> void;
+		auto TrackAudioStationStatesHandler(const std::vector<station_state>& stations) -> void;
+		auto TrackAudioStationStateUpdateHandler(const station_state& station) -> void;
+		static auto TrackAudioStationState(const nlohmann::json& data) -> station_state;
+		auto AFVTransmissionHandler(const std::string& message) -> void;
+		auto AFVStationStateHandler(const std::string& message) -> void;
+
+	public:
+		explicit plugin_engine(plugin_host& _host) : host(_host) {};
+		plugin_engine(const plugin_engine&) = delete;
+		plugin_engine& operator=(const plugin_engine&) = delete;
+
+		// settings
+		auto LoadBridgeSettings(void) -> void;
+		auto LoadRandomSeed(void) -> void;
+		auto SetPositionSettings(const std::shared_ptr<const position_settings>& settings) -> void;
+		auto GetBridgeMode(void) -> bool;
+		auto SetBridgeMode(const bool& enabled) -> void;
+		auto GetTrackAudioBridgeMode(void) -> bool;
+
+		// events, posting and frame parsing are safe to call on any thread
+		auto PostEvent(plugin_event&& event) -> void;
+		auto PostStatusMessage(const event_type& type, const std::string& msg) -> void; // shown on host thread
+		auto TrackAudioFrameHandler(const std::string& message, const std::chrono::steady_clock::time_point& arrival) -> void;
+		auto ProcessEvents(std::vector<double>* latencies) -> bool; // return true if records are changed, latencies (ms) are appended if not null
+		inline auto QueueSize(void) const -> size_t { return queueEvent.size(); }
+		inline auto QueueDrops(void) const -> size_t { return queueEvent.drops(); }
+		inline auto EventsProcessed(void) const -> size_t { return countEventProcessed; }
+		inline auto CallsignsInterned(void) const -> size_t { return callsignTable.Size(); }
+
+		// records
+		auto ClearTransmission(void) -> void;
+		inline auto GetSnapshot(void) const -> std::shared_ptr<const transmission_snapshot> { return publishedTransmission.load(); } // lock-free
+		auto IsPreviousTransmitter(const std::string_view& callsign) const -> bool; // lock-free, for tag items
+		auto RecordDrawLatency(const callsign_position& drawPosition) -> void;
+		auto ReportStats(void) -> void;
+		auto ResetStats(void) -> void;
+
+		// host callbacks
+		auto OnRadarTargetPositionUpdate(const std::string_view& callsign, const target_data& target) -> void;
+		auto OnControllerPositionUpdate(const std::string_view& callsign, const geo_position& position) -> void;
+		auto OnControllerDisconnect(const std::string_view& callsign) -> void;
+		auto OnFlightPlanDisconnect(const std::string_view& callsign) -> void;
+		auto PruneCallsigns(const std::chrono::steady_clock::time_point& now) -> void; // from timer, drops stale data and unused callsigns
+
+		// channels
+		auto IndexGroundToAirChannels(const bool& force) -> void; // enumerates only if forced or signature is changed
+		auto UpdateChannel(const std::optional<std::string>& callsign, const std::optional<chnl_state>& channelState) -> void;
+	};
+
+}
+
+#endif // !RDFENGINE_H
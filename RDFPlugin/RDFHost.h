@@ -0,0 +1,61 @@
+#pragma once
+
+#ifndef RDFHOST_H
+#define RDFHOST_H
+
+#include "RDFCore.h"
+
+namespace RDFCommon {
+
+	// Host API used by core, implemented by CRDFPlugin on EuroScope and by the simulator
+	// All calls are made on host thread
+
+	// Radar target lookup
+	class target_provider {
+	public:
+		virtual ~target_provider(void) = default;
+		virtual auto SelectRadarTarget(const std::string& callsign) -> std::optional<target_data> = 0; // std::nullopt if not found
+	};
+
+	// Controller lookup
+	class controller_provider {
+	public:
+		virtual ~controller_provider(void) = default;
+		virtual auto SelectController(const std::string& callsign) -> std::optional<geo_position> = 0; // std::nullopt if not found
+	};
+
+	// Ground to air channels, a handle is the position in last enumeration
+	class channel_provider {
+	public:
+		virtual ~channel_provider(void) = default;
+		virtual auto EnumerateChannels(std::vector<chnl_entry>& channels) -> void = 0; // resized to all channels in host order, existing entries are reused
+		virtual auto GetChannelSignature(void) -> chnl_signature = 0; // same as ChannelSignature of an enumeration, without reading channel states
+		virtual auto IsChannel(const size_t& handle, const std::string& name) -> bool = 0; // false if handle is stale
+		virtual auto GetChannelState(const size_t& handle) -> std::optional<chnl_state> = 0; // live state, std::nullopt if handle is invalid
+		virtual auto ToggleTextReceive(const size_t& handle) -> void = 0;
+		virtual auto ToggleTextTransmit(const size_t& handle) -> void = 0;
+	};
+
+	// Settings storage
+	class settings_store {
+	public:
+		virtual ~settings_store(void) = default;
+		virtual auto GetSetting(const std::string& name) -> std::optional<std::string> = 0; // std::nullopt if not set
+		virtual auto SaveSetting(const std::string& name, const std::string& description, const std::string& value) -> void = 0;
+	};
+
+	enum class message_level {
+		Silent,
+		Debug, // debug builds only
+		Unread
+	};
+
+	class plugin_host : public target_provider, public controller_provider, public channel_provider, public settings_store {
+	public:
+		virtual auto DisplayMessage(const message_level& level, const std::string& msg) -> void = 0;
+		virtual auto IsDirectConnection(void) -> bool = 0; // TrackAudio bridge is limited to direct connection
+	};
+
+}
+
+#endif // !RDFHOST_H
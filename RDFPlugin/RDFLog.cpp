@@ -0,0 +1,112 @@
+#pragma once
+
+#include "stdafx.h"
+#include "RDFLog.h"
+
+RDFCommon::async_appender::~async_appender(void)
+{
+	Stop();
+}
+
+auto RDFCommon::async_appender::Start(const std::filesystem::path& path, const size_t& fileSize, const int& files) -> void
+{
+	if (threadFlush.joinable()) return;
+	pathLog = path;
+	maxFileSize = fileSize;
+	maxFiles = files;
+	flushStop = false;
+	threadFlush = std::thread([this](void) {
+		while (!flushStop) {
+			Flush();
+			std::this_thread::sleep_for(std::chrono::milliseconds(LOG_FLUSH_INTERVAL_MS));
+		}
+		Flush();
+		fileLog.close();
+		});
+}
+
+auto RDFCommon::async_appender::Stop(void) -> void
+{
+	if (threadFlush.joinable()) {
+		flushStop = true;
+		threadFlush.join();
+	}
+}
+
+auto RDFCommon::async_appender::write(const plog::Record& record) -> void
+{
+	// caller thread: copy fields only, never blocks
+	log_entry entry;
+	entry.severity = record.getSeverity();
+	entry.time = record.getTime();
+	entry.tid = record.getTid();
+	entry.func = record.getFunc();
+	entry.line = record.getLine();
+	entry.message = record.getMessage();
+	queueLog.push_evict(std::move(entry));
+}
+
+auto RDFCommon::async_appender::Flush(void) -> void
+{
+	log_entry entry;
+	bool written = false;
+	while (queueLog.pop(entry)) {
+		if (!fileLog.is_open()) {
+			fileLog.open(pathLog, std::ios::binary | std::ios::app);
+			if (!fileLog.is_open()) continue;
+			std::error_code ec;
+			auto size = std::filesystem::file_size(pathLog, ec); // tellp is unspecified before first write in append mode
+			fileSize = ec ? 0 : (size_t)size;
+		}
+		size_t dropped = queueLog.drops();
+		if (dropped != countDropped) {
+			auto msg = std::format("log queue is full, {} entries dropped\n", dropped - countDropped);
+			fileLog << msg;
+			fileSize += msg.size();
+			countDropped = dropped;
+		}
+		auto line = Format(entry);
+		fileLog << line;
+		fileSize += line.size();
+		written = true;
+		if (maxFileSize > 0 && maxFiles > 0 && fileSize >= maxFileSize) {
+			Rotate();
+		}
+	}
+	if (written && fileLog.is_open()) {
+		fileLog.flush();
+	}
+}
+
+auto RDFCommon::async_appender::Format(const log_entry& entry) -> std::string
+{
+	// same layout as plog::TxtFormatterUtcTime
+	tm t = {};
+	gmtime_s(&t, &entry.time.time);
+	return std::format("{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:03} {:<5} [{}] [{}@{}] {}\n",
+		t.tm_year + 1900, t.tm_mon + 1, t.tm_mday, t.tm_hour, t.tm_min, t.tm_sec, entry.time.millitm,
+		plog::severityToString(entry.severity), entry.tid, entry.func, entry.line,
+		plog::UTF8Converter::convert(entry.message));
+}
+
+auto RDFCommon::async_appender::Rotate(void) -> void
+{
+	// RDFPlugin.log -> RDFPlugin.1.log -> ... -> RDFPlugin.<maxFiles - 1>.log, as plog does
+	fileLog.close();
+	auto RotatedPath = [this](const int& i) -> std::filesystem::path {
+		auto p = pathLog;
+		return p.replace_filename(std::format("{}.{}{}", pathLog.stem().string(), i, pathLog.extension().string()));
+		};
+	std::error_code ec;
+	std::filesystem::remove(RotatedPath(maxFiles - 1), ec);
+	for (int i = maxFiles - 2; i >= 1; i--) {
+		std::filesystem::rename(RotatedPath(i), RotatedPath(i + 1), ec);
+	}
+	if (maxFiles > 1) {
+		std::filesystem::rename(pathLog, RotatedPath(1), ec);
+	}
+	else {
+		std::filesystem::remove(pathLog, ec);
+	}
+	fileSize = 0;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef RDFLOG_H
+#define RDFLOG_H
+
+#include "stdafx.h"
+#include "RDFQueue.h"
+
+constexpr auto LOG_QUEUE_SIZE = 4096; // power of 2, oldest entries are dropped when full
+constexpr auto LOG_FLUSH_INTERVAL_MS = 50;
+constexpr auto LOG_FILE_SIZE_MB = 10;
+constexpr auto LOG_FILES = 3;
+
+namespace RDFCommon {
+
+	// Captured plog record, formatted on flusher thread
+	typedef struct _log_entry {
+		plog::Severity severity = plog::none;
+		plog::util::Time time = {};
+		unsigned int tid = 0;
+		std::string func;
+		size_t line = 0;
+		plog::util::nstring message;
+	} log_entry;
+
+	// plog appender with lock-free ring and background flusher, output as TxtFormatterUtcTime
+	class async_appender : public plog::IAppender {
+	private:
+		bounded_queue<log_entry, LOG_QUEUE_SIZE> queueLog;
+		std::thread threadFlush;
+		std::atomic<bool> flushStop = false;
+		std::filesystem::path pathLog;
+		size_t maxFileSize = 0; // bytes, no rolling if 0
+		int maxFiles = 0;
+
+		// flusher thread only
+		std::ofstream fileLog;
+		size_t fileSize = 0;
+		size_t countDropped = 0; // last reported
+		auto Flush(void) -> void;
+		auto Format(const log_entry& entry) -> std::string;
+		auto Rotate(void) -> void;
+
+	public:
+		async_appender(void) = default;
+		~async_appender(void);
+		auto Start(const std::filesystem::path& path, const size_t& fileSize, const int& files) -> void;
+		auto Stop(void) -> void; // drains remaining entries
+		virtual auto write(const plog::Record& record) -> void override;
+	};
+
+}
+
+#endif // !RDFLOG_H
@@ -0,0 +1,126 @@
+#pragma once
+
+#ifndef RDFQUEUE_H
+#define RDFQUEUE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace RDFCommon {
+
+	// Bounded lock-free queue after D. Vyukov, safe for multiple producers and consumers.
+	// Items are dropped (and counted) when full, either the new one or the oldest ones.
+	template <typename T, size_t Capacity>
+	class bounded_queue {
+		static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of 2");
+
+	private:
+		typedef struct _cell {
+			std::atomic<size_t> sequence;
+			T data;
+		} cell;
+
+		std::unique_ptr<cell[]> buffer;
+		alignas(64) std::atomic<size_t> enqueuePos;
+		alignas(64) std::atomic<size_t> dequeuePos;
+		alignas(64) std::atomic<size_t> dropCount;
+
+	public:
+		bounded_queue(void) :
+			buffer(new cell[Capacity]),
+			enqueuePos(0),
+			dequeuePos(0),
+			dropCount(0)
+		{
+			for (size_t i = 0; i < Capacity; i++) {
+				buffer[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		};
+
+		bounded_queue(const bounded_queue&) = delete;
+		bounded_queue& operator=(const bounded_queue&) = delete;
+
+		auto push(T&& item) -> bool {
+			// return false if queue is full, item is dropped
+			if (enqueue(item)) return true;
+			dropCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		};
+
+		auto push_evict(T&& item) -> bool {
+			// evict oldest items until there is room, return false if any is evicted
+			bool evicted = false;
+			while (!enqueue(item)) {
+				T oldest;
+				if (pop(oldest)) {
+					dropCount.fetch_add(1, std::memory_order_relaxed);
+					evicted = true;
+				}
+			}
+			return !evicted;
+		};
+
+	private:
+		auto enqueue(T& item) -> bool {
+			// item is moved only on success
+			size_t pos = enqueuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				cell& c = buffer[pos & (Capacity - 1)];
+				size_t seq = c.sequence.load(std::memory_order_acquire);
+				auto diff = (intptr_t)seq - (intptr_t)pos;
+				if (diff == 0) {
+					if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						c.data = std::move(item);
+						c.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					return false;
+				}
+				else {
+					pos = enqueuePos.load(std::memory_order_relaxed);
+				}
+			}
+		};
+
+	public:
+		auto pop(T& item) -> bool {
+			// return false if queue is empty
+			size_t pos = dequeuePos.load(std::memory_order_relaxed);
+			for (;;) {
+				cell& c = buffer[pos & (Capacity - 1)];
+				size_t seq = c.sequence.load(std::memory_order_acquire);
+				auto diff = (intptr_t)seq - (intptr_t)(pos + 1);
+				if (diff == 0) {
+					if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						item = std::move(c.data);
+						c.sequence.store(pos + Capacity, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0) {
+					return false;
+				}
+				else {
+					pos = dequeuePos.load(std::memory_order_relaxed);
+				}
+			}
+		};
+
+		auto size(void) const -> size_t {
+			// approximate while producers are active
+			size_t enq = enqueuePos.load(std::memory_order_relaxed);
+			size_t deq = dequeuePos.load(std::memory_order_relaxed);
+			return enq > deq ? enq - deq : 0;
+		};
+
+		auto drops(void) const -> size_t {
+			return dropCount.load(std::memory_order_relaxed);
+		};
+	};
+
+}
+
+#endif // !RDFQUEUE_H
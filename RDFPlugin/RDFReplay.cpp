@@ -0,0 +1,81 @@
+#include "RDFReplay.h"
+#include <cstring>
+#include <plog/Log.h>
+
+auto RDFCommon::replay_recorder::Start(const std::filesystem::path& path) -> bool
+{
+	std::unique_lock lock(mtxFile);
+	if (active) return false;
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		PLOGE << "unable to open record file: " << path.string();
+		return false;
+	}
+	file.write(REPLAY_FILE_MAGIC, std::strlen(REPLAY_FILE_MAGIC));
+	start = std::chrono::steady_clock::now();
+	count = 0;
+	active = true;
+	PLOGI << "recording to " << path.string();
+	return true;
+}
+
+auto RDFCommon::replay_recorder::Stop(void) -> size_t
+{
+	std::unique_lock lock(mtxFile);
+	if (!active) return 0;
+	active = false;
+	file.close();
+	PLOGI << "recording stopped, records: " << count;
+	return count;
+}
+
+auto RDFCommon::replay_recorder::Write(const replay_source& source, const std::string_view& payload) -> void
+{
+	if (!IsActive()) return;
+	std::unique_lock lock(mtxFile);
+	if (!active) return;
+	uint64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+	uint8_t src = (uint8_t)source;
+	uint32_t size = (uint32_t)payload.size();
+	file.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+	file.write(reinterpret_cast<const char*>(&src), sizeof(src));
+	file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+	file.write(payload.data(), size);
+	count++;
+}
+
+auto RDFCommon::ReadReplayLog(const std::filesystem::path& path, std::vector<replay_record>& records) -> bool
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		PLOGE << "unable to open record file: " << path.string();
+		return false;
+	}
+	std::string magic(std::strlen(REPLAY_FILE_MAGIC), '\0');
+	if (!file.read(magic.data(), magic.size()) || magic != REPLAY_FILE_MAGIC) {
+		PLOGE << "invalid record file: " << path.string();
+		return false;
+	}
+	records.clear();
+	for (;;) {
+		replay_record record;
+		uint8_t src;
+		uint32_t size;
+		if (!file.read(reinterpret_cast<char*>(&record.timestamp), sizeof(record.timestamp))) break;
+		if (!file.read(reinterpret_cast<char*>(&src), sizeof(src)) ||
+			!file.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+			src > (uint8_t)replay_source::AFVStationState) {
+			PLOGW << "truncated record file, records read: " << records.size();
+			break;
+		}
+		record.source = (replay_source)src;
+		record.payload.resize(size);
+		if (size && !file.read(record.payload.data(), size)) {
+			PLOGW << "truncated record file, records read: " << records.size();
+			break;
+		}
+		records.push_back(std::move(record));
+	}
+	PLOGI << "record file loaded: " << path.string() << ", records: " << records.size();
+	return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifndef RDFREPLAY_H
+#define RDFREPLAY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr auto REPLAY_FILE_MAGIC = "RDFREC01";
+constexpr auto REPLAY_FILE_EXTENSION = ".rdfrec";
+
+namespace RDFCommon {
+
+	// Inbound message sources
+	enum class replay_source : uint8_t {
+		TrackAudio = 0, // WS frame
+		AFVTransmission = 1, // RDF hidden window WM_COPYDATA
+		AFVStationState = 2 // AFV bridge hidden window WM_COPYDATA
+	};
+
+	// Record layout: u64 timestamp (us since capture start), u8 source, u32 size, payload
+	typedef struct _replay_record {
+		uint64_t timestamp;
+		replay_source source;
+		std::string payload;
+	} replay_record;
+
+	// Thread-safe capture of inbound messages
+	class replay_recorder {
+	private:
+		std::mutex mtxFile;
+		std::ofstream file;
+		std::chrono::steady_clock::time_point start;
+		std::atomic<bool> active = false;
+		size_t count = 0;
+
+	public:
+		auto Start(const std::filesystem::path& path) -> bool;
+		auto Stop(void) -> size_t; // return number of records
+		auto Write(const replay_source& source, const std::string_view& payload) -> void;
+		inline auto IsActive(void) const -> bool { return active.load(std::memory_order_relaxed); }
+	};
+
+	// Replay results, feed side is written by replay thread before it finishes
+	typedef struct _replay_stats {
+		size_t records = 0;
+		double feedSeconds = 0;
+		std::vector<double> latency; // ms, posted -> processed on host thread
+	} replay_stats;
+
+	auto ReadReplayLog(const std::filesystem::path& path, std::vector<replay_record>& records) -> bool;
+
+}
+
+#endif // !RDFREPLAY_H
@@ -0,0 +1,43 @@
+#include "RDFStats.h"
+#include <algorithm>
+#include <cmath>
+
+auto RDFCommon::latency_histogram::BucketValue(const size_t& index) -> uint64_t
+{
+	if (index < SUB_COUNT) return index;
+	size_t shift = index / SUB_COUNT - 1;
+	uint64_t lower = (uint64_t)(index % SUB_COUNT + SUB_COUNT) << shift;
+	return lower + ((uint64_t)1 << shift) - 1;
+}
+
+auto RDFCommon::latency_histogram::Record(const std::chrono::steady_clock::duration& latency) -> void
+{
+	static_assert(BucketIndex(((uint64_t)1 << MAX_BITS) - 1) == BUCKET_COUNT - 1, "largest value must land in last bucket");
+	auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+	uint64_t value = (std::min)((uint64_t)(std::max)(us, (decltype(us))0), ((uint64_t)1 << MAX_BITS) - 1);
+	counts[BucketIndex(value)]++;
+	total++;
+	maxValue = (std::max)(maxValue, value);
+}
+
+auto RDFCommon::latency_histogram::Percentile(const double& p) const -> double
+{
+	if (!total) return 0;
+	uint64_t rank = (uint64_t)std::ceil(std::clamp(p, 0.0, 1.0) * (double)total);
+	rank = (std::max)(rank, (uint64_t)1);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < counts.size(); i++) {
+		seen += counts[i];
+		if (seen >= rank) {
+			return (double)(std::min)(BucketValue(i), maxValue) / 1000.0;
+		}
+	}
+	return Max();
+}
+
+auto RDFCommon::latency_histogram::Reset(void) -> void
+{
+	counts.fill(0);
+	total = 0;
+	maxValue = 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#ifndef RDFSTATS_H
+#define RDFSTATS_H
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace RDFCommon {
+
+	// HDR-style latency histogram in microseconds, log-linear buckets with ~3% relative error, not thread-safe
+	class latency_histogram {
+	private:
+		static constexpr size_t SUB_BITS = 5; // sub-buckets per power of two = 2^SUB_BITS
+		static constexpr size_t SUB_COUNT = (size_t)1 << SUB_BITS;
+		static constexpr size_t MAX_BITS = 36; // values are clamped below 2^36 us (~19 hours)
+		static constexpr size_t BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT; // exact range plus one row per power of two up to 2^MAX_BITS
+
+		std::array<uint64_t, BUCKET_COUNT> counts = {};
+		uint64_t total = 0;
+		uint64_t maxValue = 0;
+
+		static constexpr auto BucketIndex(const uint64_t& value) -> size_t
+		{
+			// exact below SUB_COUNT, then SUB_COUNT buckets per power of two
+			if (value < SUB_COUNT) return (size_t)value;
+			size_t shift = (size_t)std::bit_width(value) - SUB_BITS - 1;
+			return (shift + 1) * SUB_COUNT + (size_t)(value >> shift) - SUB_COUNT;
+		}
+		static auto BucketValue(const size_t& index) -> uint64_t; // highest value in bucket
+
+	public:
+		auto Record(const std::chrono::steady_clock::duration& latency) -> void;
+		auto Percentile(const double& p) const -> double; // ms, p in [0, 1]
+		inline auto Max(void) const -> double { return (double)maxValue / 1000.0; } // ms
+		inline auto Count(void) const -> uint64_t { return total; }
+		auto Reset(void) -> void;
+	};
+
+}
+
+#endif // !RDFSTATS_H
@@ -0,0 +1,88 @@
+#include "RDFTrace.h"
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <plog/Log.h>
+
+static std::atomic<bool> traceActive = false;
+static std::atomic<std::chrono::steady_clock::rep> traceStart = 0; // ticks of steady_clock
+static std::mutex mtxTraceBuffers; // guards registration and export
+static std::vector<std::shared_ptr<RDFCommon::trace_buffer>> traceBuffers; // kept after thread exits
+static std::atomic<uint32_t> traceThreads = 0; // trace tid by registration order
+
+static auto TraceLocalBuffer(void) -> RDFCommon::trace_buffer&
+{
+	thread_local std::shared_ptr<RDFCommon::trace_buffer> buffer = [](void) {
+		auto b = std::make_shared<RDFCommon::trace_buffer>();
+		b->tid = ++traceThreads;
+		std::unique_lock lock(mtxTraceBuffers);
+		traceBuffers.push_back(b);
+		return b;
+		}();
+	return *buffer;
+}
+
+auto RDFCommon::TraceStart(void) -> bool
+{
+	std::unique_lock lock(mtxTraceBuffers);
+	if (traceActive) return false;
+	for (auto& buffer : traceBuffers) {
+		std::unique_lock block(buffer->mtx);
+		buffer->events.clear();
+	}
+	traceStart = std::chrono::steady_clock::now().time_since_epoch().count();
+	traceActive = true;
+	return true;
+}
+
+auto RDFCommon::TraceStop(const std::filesystem::path& path) -> size_t
+{
+	std::unique_lock lock(mtxTraceBuffers);
+	if (!traceActive) return 0;
+	traceActive = false;
+	nlohmann::json events = nlohmann::json::array();
+	size_t count = 0;
+	for (auto& buffer : traceBuffers) {
+		std::unique_lock block(buffer->mtx);
+		if (buffer->name.size()) {
+			events.push_back({ {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", buffer->tid}, {"args", {{"name", buffer->name}}} });
+		}
+		for (const auto& e : buffer->events) {
+			events.push_back({ {"name", e.name}, {"ph", "X"}, {"pid", 1}, {"tid", buffer->tid}, {"ts", e.begin}, {"dur", e.duration} });
+		}
+		count += buffer->events.size();
+		buffer->events.clear();
+		buffer->events.shrink_to_fit();
+	}
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		PLOGE << "unable to open trace file: " << path.string();
+		return 0;
+	}
+	file << nlohmann::json({ {"traceEvents", events}, {"displayTimeUnit", "ms"} }).dump();
+	PLOGI << "trace written to " << path.string() << ", spans: " << count;
+	return count;
+}
+
+auto RDFCommon::TraceThreadName(const char* name) -> void
+{
+	auto& buffer = TraceLocalBuffer();
+	if (buffer.name.empty()) {
+		std::unique_lock lock(buffer.mtx);
+		buffer.name = name;
+	}
+}
+
+auto RDFCommon::TraceRecord(const char* name, const std::chrono::steady_clock::time_point& begin) -> void
+{
+	if (!traceActive.load(std::memory_order_relaxed)) return;
+	auto end = std::chrono::steady_clock::now();
+	auto start = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(traceStart.load()));
+	auto& buffer = TraceLocalBuffer();
+	std::unique_lock lock(buffer.mtx);
+	if (!traceActive || begin < start || buffer.events.size() >= TRACE_BUFFER_EVENTS) return;
+	buffer.events.push_back({ name,
+		std::chrono::duration_cast<std::chrono::microseconds>(begin - start).count(),
+		std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() });
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#ifndef RDFTRACE_H
+#define RDFTRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+constexpr auto TRACE_BUFFER_EVENTS = 1 << 18; // per thread, further spans are dropped
+constexpr auto TRACE_FILE_EXTENSION = ".trace.json";
+
+namespace RDFCommon {
+
+	// Complete span, microseconds since trace start
+	typedef struct _trace_event {
+		const char* name; // string literal
+		int64_t begin;
+		int64_t duration;
+	} trace_event;
+
+	// Per-thread span buffer, mutex is only contended while exporting
+	typedef struct _trace_buffer {
+		std::mutex mtx;
+		uint32_t tid = 0; // in order of registration, not OS thread id
+		std::string name;
+		std::vector<trace_event> events;
+	} trace_buffer;
+
+	auto TraceStart(void) -> bool; // return false if already tracing
+	auto TraceStop(const std::filesystem::path& path) -> size_t; // write Chrome trace JSON, return number of spans
+	auto TraceThreadName(const char* name) -> void;
+	auto TraceRecord(const char* name, const std::chrono::steady_clock::time_point& begin) -> void;
+
+	// Records a span from construction to destruction while tracing
+	class trace_scope {
+	private:
+		const char* name;
+		std::chrono::steady_clock::time_point begin;
+
+	public:
+		explicit trace_scope(const char* _name) : name(_name), begin(std::chrono::steady_clock::now()) {};
+		~trace_scope(void) { TraceRecord(name, begin); };
+		trace_scope(const trace_scope&) = delete;
+		trace_scope& operator=(const trace_scope&) = delete;
+	};
+
+}
+
+// Tracing macros, compiled out unless RDF_TRACE is defined
+#define RDF_TRACE_CONCAT_(a, b) a##b
+#define RDF_TRACE_CONCAT(a, b) RDF_TRACE_CONCAT_(a, b)
+#ifdef RDF_TRACE
+#define RDF_TRACE_SCOPE(name) RDFCommon::trace_scope RDF_TRACE_CONCAT(rdfTraceScope, __LINE__)(name)
+#define RDF_TRACE_LOCK(guard, name) do { RDF_TRACE_SCOPE(name); (guard).lock(); } while (0)
+#define RDF_TRACE_THREAD(name) RDFCommon::TraceThreadName(name)
+#else
+#define RDF_TRACE_SCOPE(name) ((void)0)
+#define RDF_TRACE_LOCK(guard, name) (guard).lock()
+#define RDF_TRACE_THREAD(name) ((void)0)
+#endif // RDF_TRACE
+
+#endif // !RDFTRACE_H
@@ -0,0 +1,240 @@
+#include "RDFSimulator.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <iostream>
+
+static constexpr std::array<const char*, 8> SIM_AIRLINES = { "CPA", "CES", "CSN", "HDA", "UAL", "BAW", "DLH", "SIA" };
+static constexpr RDFCommon::geo_position SIM_CENTER = { 22.3, 113.9 };
+
+RDFCommon::sim_host::sim_host(const sim_settings& _settings) :
+	settings(_settings),
+	random(_settings.seed)
+{
+	// radar targets spread around center, callsigns are unique by sequence
+	for (size_t i = 0; i < settings.targets; i++) {
+		sim_target target;
+		target.callsign = std::string(SIM_AIRLINES[i % SIM_AIRLINES.size()]) + std::to_string(100 + i / SIM_AIRLINES.size());
+		target.data.position = { SIM_CENTER.latitude + (random.Uniform() - 0.5) * 10.0, SIM_CENTER.longitude + (random.Uniform() - 0.5) * 10.0 };
+		target.data.altitude = (int)(random.Uniform() * 40000.0);
+		target.heading = random.Uniform() * 360.0;
+		target.speed = 150.0 + random.Uniform() * 330.0;
+		targetIndex.emplace(target.callsign, targets.size());
+		targets.push_back(std::move(target));
+	}
+	// one controller per channel, frequencies wrap around airband so duplicates exist
+	for (size_t i = 0; i < settings.channels; i++) {
+		chnl_entry entry;
+		entry.name = "SIM" + std::to_string(i) + (i % 3 == 0 ? "_APP" : "_CTR");
+		entry.state.frequency = 118000 + (int)(i * 25 % 19000);
+		entry.state.isPrim = i == 0;
+		entry.state.isAtis = i % 50 == 49;
+		controllers.emplace(entry.name, geo_position{ SIM_CENTER.latitude + (random.Uniform() - 0.5) * 10.0, SIM_CENTER.longitude + (random.Uniform() - 0.5) * 10.0 });
+		channels.push_back(std::move(entry));
+	}
+	store[SETTING_ENABLE_BRIDGE] = "1";
+	store[SETTING_RANDOM_SEED] = std::to_string(settings.seed);
+	store[SETTING_BRIDGE_WINDOW] = std::to_string(BRIDGE_WINDOW_MS);
+}
+
+auto RDFCommon::sim_host::Step(plugin_engine& engine, const double& seconds) -> void
+{
+	// every target reports once per update period, spread over steps
+	if (targets.empty()) return;
+	dueUpdates += (double)targets.size() * seconds / settings.updatePeriod;
+	size_t count = (std::min)((size_t)dueUpdates, targets.size());
+	dueUpdates -= (double)count;
+	for (size_t i = 0; i < count; i++) {
+		auto& target = targets[nextUpdate];
+		nextUpdate = (nextUpdate + 1) % targets.size();
+		AddOffset(target.data.position, target.heading, target.speed * settings.updatePeriod / 3600.0);
+		engine.OnRadarTargetPositionUpdate(target.callsign, target.data);
+	}
+}
+
+auto RDFCommon::sim_host::SelectRadarTarget(const std::string& callsign) -> std::optional<target_data>
+{
+	counters.selectRadarTarget++;
+	auto it = targetIndex.find(callsign);
+	if (it == targetIndex.end()) {
+		return std::nullopt;
+	}
+	return targets[it->second].data;
+}
+
+auto RDFCommon::sim_host::SelectController(const std::string& callsign) -> std::optional<geo_position>
+{
+	counters.selectController++;
+	auto it = controllers.find(callsign);
+	if (it == controllers.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
+
+auto RDFCommon::sim_host::EnumerateChannels(std::vector<chnl_entry>& entries) -> void
+{
+	counters.enumerateChannels++;
+	entries.resize(channels.size());
+	for (size_t i = 0; i < channels.size(); i++) {
+		entries[i].name = channels[i].name;
+		entries[i].state = channels[i].state;
+	}
+}
+
+auto RDFCommon::sim_host::GetChannelSignature(void) -> chnl_signature
+{
+	counters.channelSignatures++;
+	return ChannelSignature(channels);
+}
+
+auto RDFCommon::sim_host::IsChannel(const size_t& handle, const std::string& name) -> bool
+{
+	return handle < channels.size() && channels[handle].name == name;
+}
+
+auto RDFCommon::sim_host::GetChannelState(const size_t& handle) -> std::optional<chnl_state>
+{
+	if (handle >= channels.size()) {
+		return std::nullopt;
+	}
+	counters.channelReads++;
+	return channels[handle].state;
+}
+
+auto RDFCommon::sim_host::ToggleTextReceive(const size_t& handle) -> void
+{
+	if (handle < channels.size()) {
+		counters.toggles++;
+		channels[handle].state.rx = !channels[handle].state.rx;
+	}
+}
+
+auto RDFCommon::sim_host::ToggleTextTransmit(const size_t& handle) -> void
+{
+	if (handle < channels.size()) {
+		counters.toggles++;
+		channels[handle].state.tx = !channels[handle].state.tx;
+	}
+}
+
+auto RDFCommon::sim_host::GetSetting(const std::string& name) -> std::optional<std::string>
+{
+	auto it = store.find(name);
+	if (it == store.end()) {
+		return std::nullopt;
+	}
+	return it->second;
+}
+
+auto RDFCommon::sim_host::SaveSetting(const std::string& name, const std::string&, const std::string& value) -> void
+{
+	store[name] = value;
+}
+
+auto RDFCommon::sim_host::DisplayMessage(const message_level& level, const std::string& msg) -> void
+{
+	// debug messages are per toggle, only printed when verbose
+	counters.messages++;
+	if (level != message_level::Debug || settings.verbose) {
+		std::cout << msg << std::endl;
+	}
+}
+
+auto RDFCommon::sim_host::IsDirectConnection(void) -> bool
+{
+	return true;
+}
+
+RDFCommon::sim_feeder::sim_feeder(const sim_host& host, const uint64_t& seed) :
+	random(seed),
+	channels(host.Channels())
+{
+	// pilots and controllers both transmit
+	for (const auto& target : host.Targets()) {
+		callsigns.push_back(target.callsign);
+	}
+	for (const auto& channel : channels) {
+		callsigns.push_back(channel.name);
+	}
+}
+
+auto RDFCommon::sim_feeder::TrackAudioStation(const chnl_entry& channel, const bool& rx, const bool& tx) -> std::string
+{
+	return nlohmann::json({
+		{ "callsign", channel.name },
+		{ "frequency", channel.state.frequency * 1000 },
+		{ "rx", rx },
+		{ "tx", tx },
+		{ "xc", false },
+		{ "xca", false },
+		{ "headset", true },
+		{ "isOutputMuted", false },
+		{ "outputVolume", 100 }
+		}).dump();
+}
+
+auto RDFCommon::sim_feeder::Next(plugin_engine& engine) -> void
+{
+	// message mix roughly follows a busy session, transmitters are bounded
+	auto Pick = [&](const auto& items) -> const auto& {
+		return items[(size_t)(random.Uniform() * (double)items.size())];
+		};
+	double r = random.Uniform();
+	if (r < 0.55 && callsigns.size()) {
+		// TrackAudio RX begin/end as sent by TrackAudio
+		bool end = transmitting.size() && (transmitting.size() >= 20 || random.Uniform() < 0.5);
+		std::string callsign;
+		if (end) {
+			size_t i = (size_t)(random.Uniform() * (double)transmitting.size());
+			callsign = transmitting[i];
+			transmitting.erase(transmitting.begin() + i);
+		}
+		else {
+			callsign = Pick(callsigns);
+			transmitting.push_back(callsign);
+		}
+		std::string frame = std::string(R"({"type":")") + (end ? "kRxEnd" : "kRxBegin") +
+			R"(","value":{"callsign":")" + callsign + R"(","pFrequencyHz":118700000}})";
+		engine.TrackAudioFrameHandler(frame, std::chrono::steady_clock::now());
+	}
+	else if (r < 0.75 && callsigns.size()) {
+		// AFV resends the full transmitter list
+		if (afvTransmitting.size() && (afvTransmitting.size() >= 10 || random.Uniform() < 0.5)) {
+			afvTransmitting.erase(afvTransmitting.begin() + (size_t)(random.Uniform() * (double)afvTransmitting.size()));
+		}
+		else {
+			afvTransmitting.push_back(Pick(callsigns));
+		}
+		plugin_event event;
+		event.type = event_type::AFVTransmission;
+		for (const auto& callsign : afvTransmitting) {
+			event.message += callsign + ":";
+		}
+		engine.PostEvent(std::move(event));
+	}
+	else if (r < 0.90 && channels.size()) {
+		// TrackAudio station update
+		std::string frame = R"({"type":"kStationStateUpdate","value":)" + TrackAudioStation(Pick(channels), random.Uniform() < 0.5, random.Uniform() < 0.3) + "}";
+		engine.TrackAudioFrameHandler(frame, std::chrono::steady_clock::now());
+	}
+	else if (r < 0.99 && channels.size()) {
+		// AFV bridge station state
+		const auto& channel = Pick(channels);
+		char frequency[16];
+		snprintf(frequency, sizeof(frequency), "%d.%03d", channel.state.frequency / 1000, channel.state.frequency % 1000);
+		plugin_event event;
+		event.type = event_type::AFVStationState;
+		event.message = std::string(frequency) + (random.Uniform() < 0.5 ? ":True" : ":False") + (random.Uniform() < 0.3 ? ":True" : ":False");
+		engine.PostEvent(std::move(event));
+	}
+	else if (channels.size()) {
+		// full station states, as replied to kGetStationStates
+		std::string frame = R"({"type":"kStationStates","value":{"stations":[)";
+		for (size_t i = 0; i < 10; i++) {
+			frame += std::string(i ? "," : "") + R"({"type":"kStationStateUpdate","value":)" + TrackAudioStation(Pick(channels), random.Uniform() < 0.5, random.Uniform() < 0.3) + "}";
+		}
+		frame += "]}}";
+		engine.TrackAudioFrameHandler(frame, std::chrono::steady_clock::now());
+	}
+}
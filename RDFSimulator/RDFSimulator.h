@@ -0,0 +1,98 @@
+#pragma once
+
+#ifndef RDFSIMULATOR_H
+#define RDFSIMULATOR_H
+
+#include "RDFCore.h"
+#include "RDFEngine.h"
+#include "RDFHost.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace RDFCommon {
+
+	// Scenario of synthetic traffic
+	typedef struct _sim_settings {
+		size_t targets = 2000;
+		size_t channels = 500;
+		size_t messages = 200000; // inbound TrackAudio & AFV messages
+		uint64_t seed = 1;
+		double updatePeriod = 5.0; // seconds, radar target position updates like EuroScope
+		bool verbose = false; // print host messages
+	} sim_settings;
+
+	// Synthetic radar target, moves on great circles
+	typedef struct _sim_target {
+		std::string callsign;
+		target_data data;
+		double heading; // degrees
+		double speed; // knots
+	} sim_target;
+
+	// Counters of host API calls made by core
+	typedef struct _sim_counters {
+		size_t selectRadarTarget = 0;
+		size_t selectController = 0;
+		size_t enumerateChannels = 0;
+		size_t channelSignatures = 0;
+		size_t channelReads = 0; // single channel states
+		size_t toggles = 0;
+		size_t messages = 0;
+	} sim_counters;
+
+	// In-process EuroScope stand-in implementing host API, not thread-safe like EuroScope
+	class sim_host : public plugin_host {
+	private:
+		sim_settings settings;
+		random_generator random;
+		std::vector<sim_target> targets;
+		std::unordered_map<std::string, size_t> targetIndex;
+		std::unordered_map<std::string, geo_position> controllers;
+		std::vector<chnl_entry> channels; // position is handle
+		std::unordered_map<std::string, std::string> store;
+		size_t nextUpdate = 0; // round robin of position updates
+		double dueUpdates = 0.0; // fraction carried to next step
+
+	public:
+		sim_counters counters;
+
+		explicit sim_host(const sim_settings& _settings);
+		inline auto Targets(void) const -> const std::vector<sim_target>& { return targets; }
+		inline auto Channels(void) const -> const std::vector<chnl_entry>& { return channels; }
+		auto Step(plugin_engine& engine, const double& seconds) -> void; // move targets due for position update and report them to engine
+
+		// plugin_host
+		virtual auto SelectRadarTarget(const std::string& callsign) -> std::optional<target_data>;
+		virtual auto SelectController(const std::string& callsign) -> std::optional<geo_position>;
+		virtual auto EnumerateChannels(std::vector<chnl_entry>& entries) -> void;
+		virtual auto GetChannelSignature(void) -> chnl_signature;
+		virtual auto IsChannel(const size_t& handle, const std::string& name) -> bool;
+		virtual auto GetChannelState(const size_t& handle) -> std::optional<chnl_state>;
+		virtual auto ToggleTextReceive(const size_t& handle) -> void;
+		virtual auto ToggleTextTransmit(const size_t& handle) -> void;
+		virtual auto GetSetting(const std::string& name) -> std::optional<std::string>;
+		virtual auto SaveSetting(const std::string& name, const std::string& description, const std::string& value) -> void;
+		virtual auto DisplayMessage(const message_level& level, const std::string& msg) -> void;
+		virtual auto IsDirectConnection(void) -> bool;
+	};
+
+	// Feeds messages as TrackAudio WS and AFV hidden windows would, from one producer thread
+	class sim_feeder {
+	private:
+		random_generator random;
+		std::vector<std::string> callsigns; // transmitters are picked from
+		std::vector<chnl_entry> channels;
+		std::vector<std::string> transmitting; // TrackAudio RX
+		std::vector<std::string> afvTransmitting;
+
+		auto TrackAudioStation(const chnl_entry& channel, const bool& rx, const bool& tx) -> std::string;
+
+	public:
+		sim_feeder(const sim_host& host, const uint64_t& seed);
+		auto Next(plugin_engine& engine) -> void; // post one message
+	};
+
+}
+
+#endif // !RDFSIMULATOR_H
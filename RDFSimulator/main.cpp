@@ -0,0 +1,161 @@
+#include "RDFBench.h"
+#include "RDFCheck.h"
+#include "RDFSimulator.h"
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <plog/Init.h>
+#include <plog/Appenders/ConsoleAppender.h>
+#include <plog/Formatters/TxtFormatter.h>
+
+static auto Usage(void) -> int
+{
+	std::cerr << "usage: RDFSimulator [--targets N] [--channels N] [--messages N] [--seed N] [--verbose] [--trace] [--check] [--bench N]" << std::endl;
+	return 2;
+}
+
+int main(int argc, char* argv[])
+{
+	RDFCommon::sim_settings settings;
+	bool check = false;
+	bool trace = false;
+	size_t bench = 0;
+	try {
+		for (int i = 1; i < argc; i++) {
+			std::string arg = argv[i];
+			if (arg == "--verbose") {
+				settings.verbose = true;
+				continue;
+			}
+			if (arg == "--trace") {
+				trace = true;
+				continue;
+			}
+			if (arg == "--check") {
+				check = true;
+				continue;
+			}
+			if (i + 1 >= argc) return Usage();
+			auto value = std::stoull(argv[++i]);
+			if (arg == "--targets") settings.targets = value;
+			else if (arg == "--channels") settings.channels = value;
+			else if (arg == "--messages") settings.messages = value;
+			else if (arg == "--seed") settings.seed = value;
+			else if (arg == "--bench") bench = value;
+			else return Usage();
+		}
+	}
+	catch (std::exception const& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return Usage();
+	}
+	static plog::ConsoleAppender<plog::TxtFormatter> appender(plog::streamStdErr);
+	plog::init(settings.verbose ? plog::debug : plog::warning, &appender);
+
+	// self checks and microbenchmarks run instead of simulation
+	if (check || bench) {
+		bool passed = true;
+#ifdef RDF_SELF_CHECK
+		if (check) {
+			passed = RDFCommon::SelfCheck();
+			std::cout << "Self check " << (passed ? "passed." : "failed, see log.") << std::endl;
+		}
+#else
+		if (check) {
+			std::cerr << "Error: built without RDF_SELF_CHECK" << std::endl;
+			passed = false;
+		}
+#endif // RDF_SELF_CHECK
+		if (bench) {
+			for (const auto& line : RDFCommon::RunBenchmarks(bench)) {
+				std::cout << line << std::endl;
+			}
+		}
+		return passed ? 0 : 1;
+	}
+
+#ifdef RDF_TRACE
+	if (trace) {
+		RDF_TRACE_THREAD("EuroScope");
+		RDFCommon::TraceStart();
+	}
+#else
+	if (trace) {
+		std::cerr << "Error: built without RDF_TRACE" << std::endl;
+		return 1;
+	}
+#endif // RDF_TRACE
+
+	// EuroScope side, everything below runs on this thread like the EuroScope thread
+	RDFCommon::sim_host host(settings);
+	RDFCommon::plugin_engine engine(host);
+	engine.LoadRandomSeed();
+	engine.LoadBridgeSettings();
+	auto positionSettings = std::make_shared<RDFCommon::position_settings>();
+	positionSettings->circleThreshold = 0; // geodetic radius with altitude dependent precision
+	positionSettings->circlePrecision = 5;
+	positionSettings->lowPrecision = 2;
+	positionSettings->highPrecision = 10;
+	positionSettings->highAltitude = 30000;
+	positionSettings->drawController = true;
+	engine.SetPositionSettings(positionSettings);
+	engine.IndexGroundToAirChannels(true);
+	std::cout << "Simulating " << settings.targets << " radar targets, " << settings.channels << " channels, " << settings.messages << " messages." << std::endl;
+
+	// TrackAudio WS and AFV hidden windows, waits for room in queue so nothing is dropped
+	RDFCommon::sim_feeder feeder(host, settings.seed + 1);
+	std::atomic<bool> feeding = true;
+	auto start = std::chrono::steady_clock::now();
+	std::thread threadFeeder([&](void) {
+		RDF_TRACE_THREAD("Feeder");
+		for (size_t i = 0; i < settings.messages; i++) {
+			while (engine.QueueSize() >= EVENT_QUEUE_SIZE - 1) {
+				std::this_thread::yield();
+			}
+			feeder.Next(engine);
+		}
+		feeding = false;
+		});
+
+	// refresh loop, screens draw from snapshots and timer checks channel list every second
+	auto last = start;
+	auto lastTimer = start;
+	size_t refreshes = 0;
+	while (feeding || engine.QueueSize()) {
+		bool changed = engine.ProcessEvents(nullptr);
+		auto now = std::chrono::steady_clock::now();
+		host.Step(engine, std::chrono::duration<double>(now - last).count());
+		last = now;
+		if (now - lastTimer >= std::chrono::seconds(1)) {
+			engine.IndexGroundToAirChannels(false);
+			engine.PruneCallsigns(now);
+			lastTimer = now;
+		}
+		if (changed) {
+			engine.RecordDrawLatency(engine.GetSnapshot()->current);
+			refreshes++;
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+	threadFeeder.join();
+	engine.ProcessEvents(nullptr);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (trace) {
+		std::cout << "Trace spans: " << RDFCommon::TraceStop("RDFSimulator.trace.json") << "." << std::endl;
+	}
+
+	std::cout << std::fixed << std::setprecision(3) << "Wall time: " << seconds << "s, throughput: " << std::setprecision(0)
+		<< (seconds > 0 ? (double)settings.messages / seconds : 0.0) << "/s, refreshes with changes: " << refreshes << "." << std::endl;
+	engine.ReportStats();
+	std::cout << "Host API calls, radar target: " << host.counters.selectRadarTarget << ", controller: " << host.counters.selectController
+		<< ", channel enumerations: " << host.counters.enumerateChannels << ", signatures: " << host.counters.channelSignatures
+		<< ", reads: " << host.counters.channelReads << ", toggles: " << host.counters.toggles << "." << std::endl;
+	auto snapshot = engine.GetSnapshot();
+	std::cout << "Records: " << snapshot->current.size() << ", previous: " << snapshot->previous.size() << ", version: " << snapshot->version << ", callsigns: " << engine.CallsignsInterned() << "." << std::endl;
+
+	// every message must be processed, feeder never overruns queue
+	return engine.EventsProcessed() == settings.messages && !engine.QueueDrops() ? 0 : 1;
+}